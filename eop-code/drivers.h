@@ -26,6 +26,9 @@
 #include "type_functions.h"
 #include "integers.h"
 #include "eop.h"
+#include "orbits.h"
+#include "multiprecision.h"
+#include "euclidean.h"
 #include "print.h"
 #include "read.h"
 #include "assertions.h"
@@ -35,20 +38,21 @@
 
 
 template<typename F, typename P>
-    requires(Transformation(F) && T == Domain(F) &&
-        UnaryPredicate(P) && Domain(F) == Domain(P))
-void output_orbit_structure(Domain(F) x, F f, P p)
+    requires(Transformation(F) && UnaryPredicate(P) &&
+        Domain(F) == Domain(P))
+void output_orbit_structure(Domain(F) x, F, P p,
+    const triple<DistanceType(F), DistanceType(F), Domain(F)>& t,
+    const Domain(F)& y)
 {
-    triple<DistanceType(F), DistanceType(F), Domain(F)> t =
-        orbit_structure(x, f, p);
+    // Precondition: $t = \func{orbit\_structure}(x, f, p) \wedge y = \func{collision\_point}(x, f, p)$
     if (!p(t.m2)) {
         print("terminating with h-1 = "); print(t.m0);
         print(" and terminal point "); print(t.m2);
     } else if (t.m2 == x) {
-        print("circular with collision point "); print(collision_point(x, f, p));
+        print("circular with collision point "); print(y);
         print(" and c-1 = "); print(t.m1);
     } else {
-        print("rho-shaped with collision point "); print(collision_point(x, f, p));
+        print("rho-shaped with collision point "); print(y);
         print(" and h = "); print(t.m0);
         print(" and c-1 = "); print(t.m1);
         print(" and connection point "); print(t.m2);
@@ -56,15 +60,46 @@ void output_orbit_structure(Domain(F) x, F f, P p)
     print_eol();
 }
 
+template<typename F, typename P>
+    requires(Transformation(F) && T == Domain(F) &&
+        UnaryPredicate(P) && Domain(F) == Domain(P))
+void output_orbit_structure(Domain(F) x, F f, P p)
+{
+    output_orbit_structure(x, f, p, orbit_structure(x, f, p),
+                           collision_point(x, f, p));
+}
+
+template<typename F, typename P>
+    requires(Transformation(F) && UnaryPredicate(P) &&
+        Domain(F) == Domain(P))
+void output_orbit_structure_checkpointed(Domain(F) x, F f, P p,
+                                         const pointer(char) prefix,
+                                         DistanceType(F) interval)
+{
+    // An interrupted run resumes from the checkpoints when repeated
+    orbit_checkpoint_files c(prefix);
+    triple<DistanceType(F), DistanceType(F), Domain(F)> t =
+        orbit_structure_checkpointed(x, f, p, prefix, interval);
+    output_orbit_structure(x, f, p, t,
+        collision_point_checkpointed(x, f, p, c.name[0], interval));
+    remove_orbit_checkpoints(prefix);
+}
+
 template<typename I>
     requires(Integer(I))
 struct additive_congruential_transformation
 {
     I modulus;
     I index;
+    remainder_invariant<I> rem; // divides by $modulus$ without a division
     additive_congruential_transformation(I modulus, I index) :
-        modulus(modulus), index(index) { }
-    I operator()(I x) { return remainder(x + index, modulus); }
+        modulus(modulus), index(index), rem(modulus) { }
+    I operator()(I x)
+    {
+        I a = x + index;
+        if (a < I(0)) return remainder(a, modulus);
+        return rem(a, modulus);
+    }
 };
 
 template<typename I>
@@ -74,6 +109,61 @@ struct input_type<additive_congruential_transformation<I>, 0>
     typedef I type;
 };
 
+template<typename I>
+    requires(Integer(I))
+struct transformation_concept< additive_congruential_transformation<I> >
+{
+    typedef composable_transformation_tag concept;
+};
+
+template<typename I>
+    requires(Integer(I))
+additive_congruential_transformation<I>
+compose(const additive_congruential_transformation<I>& f,
+        const additive_congruential_transformation<I>& g)
+{
+    // Precondition: $f.modulus = g.modulus \wedge
+    //                0 \leq f.index, g.index < f.modulus$
+    return additive_congruential_transformation<I>(
+        f.modulus, plus_modulo_no_overflow<I>(f.modulus)(f.index, g.index));
+}
+
+
+template<typename F, typename I>
+    requires(Transformation(F) && Mutable(I) && Integer(ValueType(I)))
+struct instrumented_transformation
+{
+    F f;
+    I p;
+    instrumented_transformation(F f, I p) : f(f), p(p) { }
+    Domain(F) operator()(const Domain(F)& x)
+    {
+        ++sink(p);
+        return f(x);
+    }
+};
+
+template<typename F, typename I>
+    requires(Transformation(F) && Mutable(I) && Integer(ValueType(I)))
+struct input_type< instrumented_transformation<F, I>, 0 >
+{
+    typedef Domain(F) type;
+};
+
+template<typename F, typename I>
+    requires(Transformation(F) && Mutable(I) && Integer(ValueType(I)))
+struct distance_type< instrumented_transformation<F, I> >
+{
+    typedef DistanceType(F) type;
+};
+
+template<typename F, typename I>
+    requires(Transformation(F) && Mutable(I) && Integer(ValueType(I)))
+unsigned long long transformation_key(const instrumented_transformation<F, I>& f)
+{
+    return transformation_key(f.f);
+}
+
 
 // Definition space predicate for total transformation
 
@@ -215,9 +305,15 @@ struct LCG // linear congruential generator
     typedef long long T;
     T m, a, b, x0;
     const pointer(char) name;
+    multiplies_modulo_barrett r;
     LCG(T m, T a, T b, T x0, const pointer(char) name) :
-        m(m), a(a), b(b), x0(x0), name(name) { }
-    T operator()(T x) { return (a * x + b) % m; }
+        m(m), a(a), b(b), x0(x0), name(name), r(limb(m)) { }
+    T operator()(T x)
+    {
+        // Precondition: $x \geq 0$
+        // $a x + b$ is formed in a double limb, so it never overflows
+        return T(r.reduce(double_limb(limb(a)) * limb(x) + limb(b)));
+    }
 };
 
 template<>
@@ -232,6 +328,45 @@ struct distance_type<LCG>
     typedef unsigned long long type;
 };
 
+template<>
+struct transformation_concept<LCG>
+{
+    typedef composable_transformation_tag concept;
+};
+
+unsigned long long transformation_key(const LCG& f)
+{
+    // Identifies the checkpoints of $f$ by $m$, $a$ and $b$
+    return key_combine(key_combine(key_combine(key_basis,
+        (unsigned long long)f.m), (unsigned long long)f.a), (unsigned long long)f.b);
+}
+
+LCG compose(const LCG& f, const LCG& g)
+{
+    // Precondition: $f.m = g.m$
+    typedef LCG::T T;
+    affine_transformation<T> h = compose(
+        affine_transformation<T>(f.a % f.m, f.b % f.m, f.m),
+        affine_transformation<T>(g.a % g.m, g.b % g.m, g.m));
+    return LCG(h.m, h.a, h.b, g.x0, g.name);
+}
+
+LCG inverse(const LCG& f)
+{
+    // Precondition: $\gcd(f.a, f.m) = 1$
+    // Postcondition: $\func{inverse}(f)(f(x)) = x$ for $0 \leq x < f.m$
+    // $f^{-1}(y) = a^{-1} y - a^{-1} b \bmod m$
+    typedef LCG::T T;
+    T a = multiplicative_inverse_modulo(f.a, f.m);
+    T b = T(multiplies_modulo_wide(limb(f.m))(limb(a), limb(f.b % f.m)));
+    return LCG(f.m, a, b == T(0) ? T(0) : f.m - b, f.x0, f.name);
+}
+
+LCG lehmer_1949()
+{
+    return LCG(100000000ll+1ll, 23ll, 0ll, 47594118ll, "Lehmer 1949");
+}
+
 void run_lcg_transformation()
 {
     array<LCG> lcg;
@@ -289,7 +424,8 @@ void run_lcg_transformation()
         print("orbit of "); print(x);
         print(" under "); print(source(p + i).name);
         print(": ");
-        output_orbit_structure(source(p + i).x0, source(p + i), always_defined<LCG::T>);
+        output_orbit_structure_checkpointed(x, source(p + i), always_defined<LCG::T>,
+                                            "eop_lcg_checkpoint", 1ull << 24);
     }        
 }
 
@@ -308,6 +444,27 @@ void run_any_lcg_transformation()
 
 // Chapter 3 - Ordered algebraic structures
 
+template<typename Op, typename I>
+    requires(BinaryOperation(Op) && Mutable(I) && Integer(ValueType(I)))
+struct instrumented_operation
+{
+    Op op;
+    I p;
+    instrumented_operation(Op op, I p) : op(op), p(p) { }
+    Domain(Op) operator()(const Domain(Op)& x, const Domain(Op)& y)
+    {
+        ++sink(p);
+        return op(x, y);
+    }
+};
+
+template<typename Op, typename I>
+    requires(BinaryOperation(Op) && Mutable(I) && Integer(ValueType(I)))
+struct input_type< instrumented_operation<Op, I>, 0 >
+{
+    typedef Domain(Op) type;
+};
+
 template<typename T>
     requires(DiscreteEuclideanSemiring(T))
 struct multiplies_modulo {
@@ -329,16 +486,17 @@ void run_idempotent_power()
     print(" or two zeroes to end:\n");
     while (true)
     {
-        typedef multiplies_modulo<int> M;
-        int n, m;
+        typedef multiplies_modulo_barrett M;
+        long long n, m;
         read(n); read(m);
         if (n == 0 && m == 0) return;
-        multiplies_transformation< M > g(n, M(m));
-        int p = collision_point(n, g, always_defined<int>);
+        if (n < 0 || m <= 0) continue;
+        multiplies_transformation< M > g(limb(n) % limb(m), M(m));
+        limb p = collision_point(limb(n) % limb(m), g, always_defined<limb>);
         print("idempotent_power()("); print(n); print(", multiplication modulo ");
             print(m); print(") == ");
         	print(p); print_eol();
-        Assert(p == multiplies_modulo<int>(m)(p, p));
+        Assert(p == M(m)(p, p));
     }      
 }
 
@@ -351,7 +509,7 @@ void run_fibonacci()
         read(n);
         if (n < 0) return;
         print("fibonacci("); print(n); print(") == ");
-        print(fibonacci<long long>(n)); print_eol();
+        print(fibonacci(big_integer(n))); print_eol();
     }      
 }
 
@@ -830,6 +988,83 @@ struct input_type< instrumented_less<R, I>, 0 >
     typedef Domain(R) type;
 };
 
+// instrumented<T> counts, for the calling thread, every regular and
+// ordering operation applied to it, so that an algorithm's copies,
+// assignments and comparisons can be tabulated per element
+
+struct instrumented_base
+{
+    enum operations {
+        n, construction, default_construction, copy_construction,
+        assignment, destruction, equality, comparison
+    };
+    static const int number_ops = 8;
+    static pointer(double) counts()
+    {
+        static thread_local double c[number_ops];
+        return c;
+    }
+    static const pointer(char) name(int i)
+    {
+        static const pointer(char) names[number_ops] = {
+            "n", "construct", "default", "copy",
+            "assign", "destruct", "equal", "less"
+        };
+        return names[i];
+    }
+    static void initialize(double m)
+    {
+        // Postcondition: all counts are zero and $counts()[n] = m$
+        pointer(double) c = counts();
+        for (int i = 0; i < number_ops; i = successor(i)) c[i] = 0;
+        c[n] = m;
+    }
+};
+
+template<typename T>
+    requires(Regular(T))
+struct instrumented : instrumented_base
+{
+    T value;
+    instrumented() : value()
+    {
+        ++counts()[default_construction];
+    }
+    instrumented(const T& x) : value(x)
+    {
+        ++counts()[construction];
+    }
+    instrumented(const instrumented& x) : value(x.value)
+    {
+        ++counts()[copy_construction];
+    }
+    void operator=(const instrumented& x)
+    {
+        ++counts()[assignment];
+        value = x.value;
+    }
+    ~instrumented()
+    {
+        ++counts()[destruction];
+    }
+};
+
+template<typename T>
+    requires(Regular(T))
+bool operator==(const instrumented<T>& x, const instrumented<T>& y)
+{
+    ++instrumented_base::counts()[instrumented_base::equality];
+    return x.value == y.value;
+}
+
+template<typename T>
+    requires(TotallyOrdered(T))
+bool operator<(const instrumented<T>& x, const instrumented<T>& y)
+{
+    ++instrumented_base::counts()[instrumented_base::comparison];
+    return x.value < y.value;
+}
+
 template<typename T>
     requires(Regular(T))
 struct tracer
@@ -20,6 +20,15 @@
 
 
 #include "eop.h" // array
+#include "orbits.h"
+#include "powers.h"
+#include "multiprecision.h"
+#include "matrices.h"
+#include "selection.h"
+#include "euclidean.h"
+#include "rationals.h"
+#include "polynomials.h"
+#include "search.h"
 #include "intrinsics.h" // pointer
 #include "pointers.h"
 #include "print.h"
@@ -173,7 +173,7 @@ double euclidean_norm(double x, double y, double z) {
 
 template<typename F, typename N>
     requires(Transformation(F) && Integer(N))
-Domain(F) power_unary(Domain(F) x, N n, F f)
+Domain(F) power_unary(Domain(F) x, N n, F f, transformation_tag)
 {                  
     // Precondition:
     // $n \geq 0 \wedge (\forall i \in N)\,0 < i \leq n \Rightarrow f^i(x)$ is defined
@@ -184,6 +184,15 @@ Domain(F) power_unary(Domain(F) x, N n, F f)
     return x;
 }
 
+template<typename F, typename N>
+    requires(Transformation(F) && Integer(N))
+Domain(F) power_unary(Domain(F) x, N n, F f)
+{
+    // Precondition:
+    // $n \geq 0 \wedge (\forall i \in N)\,0 < i \leq n \Rightarrow f^i(x)$ is defined
+    return power_unary(x, n, f, TransformationConcept(F)());
+}
+
 template<typename F>
     requires(Transformation(F))
 DistanceType(F) distance(Domain(F) x, Domain(F) y, F f)
@@ -266,7 +275,7 @@ bool circular(const Domain(F)& x, F f, P p)
 
 template<typename F>
     requires(Transformation(F))
-Domain(F) convergent_point(Domain(F) x0, Domain(F) x1, F f)
+Domain(F) convergent_point(Domain(F) x0, Domain(F) x1, F f, transformation_tag)
 {
     // Precondition: $(\exists n \in \func{DistanceType}(F))\,n \geq 0 \wedge f^n(x0) = f^n(x1)$
     while (x0 != x1) {
@@ -276,6 +285,14 @@ Domain(F) convergent_point(Domain(F) x0, Domain(F) x1, F f)
     return x0;
 }
 
+template<typename F>
+    requires(Transformation(F))
+Domain(F) convergent_point(Domain(F) x0, Domain(F) x1, F f)
+{
+    // Precondition: $(\exists n \in \func{DistanceType}(F))\,n \geq 0 \wedge f^n(x0) = f^n(x1)$
+    return convergent_point(x0, x1, f, TransformationConcept(F)());
+}
+
 template<typename F>
     requires(Transformation(F))
 Domain(F)
@@ -345,6 +362,61 @@ orbit_structure(const Domain(F)& x, F f, P p)
 }
 
 
+// Cycle detection with power-of-two teleporting is due to:
+//     Richard P. Brent.
+//     An improved Monte Carlo factorization algorithm.
+//     \emph{BIT}, Volume 20, 1980, pages 176--184.
+
+template<typename F, typename P>
+    requires(Transformation(F) &&
+        UnaryPredicate(P) && Domain(F) == Domain(P))
+triple<DistanceType(F), DistanceType(F), Domain(F)>
+orbit_structure_teleporting(const Domain(F)& x, F f, P p)
+{
+    // Precondition: $p(x) \Leftrightarrow \text{$f(x)$ is defined}$
+    typedef DistanceType(F) N;
+    if (!p(x)) return triple<N, N, Domain(F)>(N(0), N(0), x);
+    Domain(F) x0 = x;          // $x0 = f^i(x)$, the previous position of $slow$
+    Domain(F) slow = x;        // $slow = f^s(x) \wedge s = 2^j - 1$
+    Domain(F) fast = f(x);     // $fast = f^{s + c}(x)$
+    N i(0);
+    N s(0);
+    N k(1);                    // $k = 2^j$
+    N c(1);
+    while (fast != slow) {     // $c \leq k$
+        if (!p(fast)) return triple<N, N, Domain(F)>(s + c, N(0), fast);
+        if (c == k) {          // teleport $slow$ to $fast$
+            x0 = slow;
+            i = s;
+            slow = fast;
+            s = s + c;
+            k = twice(k);
+            c = N(0);
+        }
+        fast = f(fast);
+        c = successor(c);
+    }
+    // $c$ is the cycle size and $slow$ is on the cycle, so $h \leq s$;
+    // if $slow$ did not collide in the previous round even though $c \leq k/2$,
+    // then $x0$ is not on the cycle and $i < h$
+    if (!(twice(c) <= k)) {
+        x0 = x;
+        i = N(0);
+    }
+    // Move $slow$ forward to the cycle point whose index is congruent to $i$
+    N d = (s - i) % c;
+    if (!zero(d)) slow = power_unary(slow, c - d, f);
+    N m = i;
+    while (x0 != slow) {
+        x0 = f(x0);
+        slow = f(slow);
+        m = successor(m);
+    }
+    return triple<N, N, Domain(F)>(m, predecessor(c), x0);
+    // Postcondition: same as $\func{orbit\_structure}(x, f, p)$
+}
+
+
 // 
 //  Chapter 3. Associative operations
 // 
@@ -1263,7 +1335,107 @@ T stein_gcd_nonnegative(T a, T b)
         } else if (b < a) {
             a = a - b;
             do { a = half_nonnegative(a); } while (even(a));
-        } else return binary_scale_up_nonnegative(a, d);
+        } else return binary_scale_up_nonnegative(a, T(d));
+}
+
+// Exercise 5.3 for the built-in integers: a count-trailing-zeros
+// instruction strips all the factors of two at once, and each step of the
+// loop exchanges $a$ and $b$ into order instead of branching on it
+
+int count_trailing_zeros(unsigned x)           { return __builtin_ctz(x); }
+int count_trailing_zeros(unsigned long x)      { return __builtin_ctzl(x); }
+int count_trailing_zeros(unsigned long long x) { return __builtin_ctzll(x); }
+
+int count_trailing_zeros(unsigned __int128 x)
+{
+    unsigned long long y = (unsigned long long)(x);
+    if (y != 0ull) return __builtin_ctzll(y);
+    return 64 + __builtin_ctzll((unsigned long long)(x >> 64));
+}
+
+template<typename U>
+    requires(UnsignedInteger(U))
+U binary_gcd_nonnegative(U a, U b)
+{
+    // Precondition: $\neg(a = 0 \wedge b = 0)$
+    if (a == U(0)) return b;
+    if (b == U(0)) return a;
+    int d = count_trailing_zeros(U(a | b));
+    a = a >> count_trailing_zeros(a);
+    do {
+        b = b >> count_trailing_zeros(b);
+        U t = b < a ? b : a;
+        b = b < a ? a : b;
+        a = t;
+        b = b - a;
+    } while (b != U(0));
+    return a << d;
+}
+
+template<typename T>
+    requires(Integer(T))
+T binary_gcd(T a, T b)
+{
+    // Precondition: $\neg(a = 0 \wedge b = 0) \wedge \gcd(a, b) \leq \max(T)$
+    // Postcondition: returns the nonnegative gcd of $a$ and $b$
+    typedef DistanceType(T) U;
+    U x = a < T(0) ? U(0) - U(a) : U(a);
+    U y = b < T(0) ? U(0) - U(b) : U(b);
+    return T(binary_gcd_nonnegative(x, y));
+}
+
+int stein_gcd_nonnegative(int a, int b)
+{
+    return binary_gcd<int>(a, b);
+}
+
+long stein_gcd_nonnegative(long a, long b)
+{
+    return binary_gcd<long>(a, b);
+}
+
+long long stein_gcd_nonnegative(long long a, long long b)
+{
+    return binary_gcd<long long>(a, b);
+}
+
+// For the built-in integers both gcd procedures use $\func{binary\_gcd}$,
+// which returns the nonnegative gcd whatever the signs of the arguments
+
+template<>
+int gcd<int>(int a, int b)
+{
+    return binary_gcd<int>(a, b);
+}
+
+template<>
+long gcd<long>(long a, long b)
+{
+    return binary_gcd<long>(a, b);
+}
+
+template<>
+long long gcd<long long>(long long a, long long b)
+{
+    return binary_gcd<long long>(a, b);
+}
+
+template<>
+int gcd<int, int>(int a, int b)
+{
+    return binary_gcd<int>(a, b);
+}
+
+template<>
+long gcd<long, long>(long a, long b)
+{
+    return binary_gcd<long>(a, b);
+}
+
+template<>
+long long gcd<long long, long long>(long long a, long long b)
+{
+    return binary_gcd<long long>(a, b);
 }
 
 template<typename T>
@@ -1417,9 +1589,45 @@ Proc for_each(I f, I l, Proc proc)
     return proc;
 }
 
+// The procedures below dispatch on StorageConcept, and those taking a
+// predicate also on PredicateConcept, so that contiguous ranges of
+// arithmetic values can be searched a block at a time; see
+// ``Quantifiers on contiguous ranges'' at the end of this chapter
+
+template<typename T>
+    requires(Regular(T))
+struct equal_to_x
+{
+    T x;
+    equal_to_x(const T& x) : x(x) { }
+    bool operator()(const T& y) { return x == y; }
+};
+
+template<typename T>
+    requires(Regular(T))
+struct input_type< equal_to_x<T>, 0 >
+{
+    typedef T type;
+};
+
+template<typename T>
+    requires(Regular(T))
+struct predicate_concept< equal_to_x<T> >
+{
+    typedef comparison_predicate_tag concept;
+};
+
 template<typename I>
     requires(Readable(I) && Iterator(I))
 I find(I f, I l, const ValueType(I)& x)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return find(f, l, x, StorageConcept(I)());
+}
+
+template<typename I, typename C>
+    requires(Readable(I) && Iterator(I) && StorageTag(C))
+I find(I f, I l, const ValueType(I)& x, C)
 {
     // Precondition: $\func{readable\_bounded\_range}(f, l)$
     while (f != l && source(f) != x) f = successor(f);
@@ -1429,6 +1637,14 @@ I find(I f, I l, const ValueType(I)& x)
 template<typename I>
     requires(Readable(I) && Iterator(I))
 I find_not(I f, I l, const ValueType(I)& x)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return find_not(f, l, x, StorageConcept(I)());
+}
+
+template<typename I, typename C>
+    requires(Readable(I) && Iterator(I) && StorageTag(C))
+I find_not(I f, I l, const ValueType(I)& x, C)
 {
     // Precondition: $\func{readable\_bounded\_range}(f, l)$
     while (f != l && source(f) == x) f = successor(f);
@@ -1439,6 +1655,16 @@ template<typename I, typename P>
     requires(Readable(I) && Iterator(I) &&
         UnaryPredicate(P) && ValueType(I) == Domain(P))
 I find_if(I f, I l, P p)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return find_if(f, l, p, StorageConcept(I)(), PredicateConcept(P)());
+}
+
+template<typename I, typename P, typename C, typename D>
+    requires(Readable(I) && Iterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P) &&
+        StorageTag(C) && PredicateTag(D))
+I find_if(I f, I l, P p, C, D)
 {
     // Precondition: $\func{readable\_bounded\_range}(f, l)$
     while (f != l && !p(source(f))) f = successor(f);
@@ -1449,6 +1675,16 @@ template<typename I,  typename P>
     requires(Readable(I) && Iterator(I) &&
         UnaryPredicate(P) && ValueType(I) == Domain(P))
 I find_if_not(I f, I l, P p)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return find_if_not(f, l, p, StorageConcept(I)(), PredicateConcept(P)());
+}
+
+template<typename I, typename P, typename C, typename D>
+    requires(Readable(I) && Iterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P) &&
+        StorageTag(C) && PredicateTag(D))
+I find_if_not(I f, I l, P p, C, D)
 {
     // Precondition: $\func{readable\_bounded\_range}(f, l)$
     while (f != l && p(source(f)))
@@ -1499,6 +1735,17 @@ template<typename I, typename P, typename J>
         UnaryPredicate(P) && Iterator(J) &&
         ValueType(I) == Domain(P))
 J count_if(I f, I l, P p, J j)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return count_if(f, l, p, j, StorageConcept(I)(), PredicateConcept(P)());
+}
+
+template<typename I, typename P, typename J, typename C, typename D>
+    requires(Readable(I) && Iterator(I) &&
+        UnaryPredicate(P) && Iterator(J) &&
+        ValueType(I) == Domain(P) &&
+        StorageTag(C) && PredicateTag(D))
+J count_if(I f, I l, P p, J j, C, D)
 {
     // Precondition: $\func{readable\_bounded\_range}(f, l)$
     while (f != l) {
@@ -1524,6 +1771,15 @@ template<typename I, typename J>
     requires(Readable(I) && Iterator(I) &&
         Iterator(J))
 J count(I f, I l, const ValueType(I)& x, J j)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return count(f, l, x, j, StorageConcept(I)());
+}
+
+template<typename I, typename J, typename C>
+    requires(Readable(I) && Iterator(I) &&
+        Iterator(J) && StorageTag(C))
+J count(I f, I l, const ValueType(I)& x, J j, C)
 {
     // Precondition: $\func{readable\_bounded\_range}(f, l)$
     while (f != l) {
@@ -1545,6 +1801,15 @@ template<typename I, typename J>
     requires(Readable(I) && Iterator(I) &&
         Iterator(J))
 J count_not(I f, I l, const ValueType(I)& x, J j)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return count_not(f, l, x, j, StorageConcept(I)());
+}
+
+template<typename I, typename J, typename C>
+    requires(Readable(I) && Iterator(I) &&
+        Iterator(J) && StorageTag(C))
+J count_not(I f, I l, const ValueType(I)& x, J j, C)
 {
     // Precondition: $\func{readable\_bounded\_range}(f, l)$
     while (f != l) {
@@ -1567,6 +1832,16 @@ template<typename I, typename P, typename J>
         UnaryPredicate(P) && Domain(P) == ValueType(I) &&
         Iterator(J))
 J count_if_not(I f, I l, P p, J j)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return count_if_not(f, l, p, j, StorageConcept(I)(), PredicateConcept(P)());
+}
+
+template<typename I, typename P, typename J, typename C, typename D>
+    requires(Readable(I) && Iterator(I) &&
+        UnaryPredicate(P) && Domain(P) == ValueType(I) &&
+        Iterator(J) && StorageTag(C) && PredicateTag(D))
+J count_if_not(I f, I l, P p, J j, C, D)
 {
     // Precondition: $\func{readable\_bounded\_range}(f, l)$
     while (f != l) {
@@ -1584,6 +1859,153 @@ DistanceType(I) count_if_not(I f, I l, P p)
     return count_if_not(f, l, p, DistanceType(I)(0));
 }
 
+
+// Quantifiers on contiguous ranges
+
+// When $\func{StorageConcept}(I)$ is $\func{contiguous\_storage\_tag}$
+// (see pointers.h) and the predicate is a comparison with a fixed value,
+// the procedures above examine a block of $\func{quantifier\_lanes}$
+// elements per step: the block is scanned without an early exit, counting
+// the elements that satisfy the predicate, which a compiler turns into a
+// few vector compares, and only a block containing a match is searched
+// element by element.
+// Predicates of this kind have no side effects, so evaluating them past
+// the first match is not observable
+
+const int quantifier_lanes = 32;
+
+template<typename I, typename P>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P))
+I find_if_lanes(I f, I l, P p)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    typedef DistanceType(I) N;
+    const N k = N(quantifier_lanes);
+    while (l - f >= k) {
+        int c = 0;
+        for (N i(0); i < k; i = successor(i))
+            if (p(source(f + i))) c = successor(c);
+        if (c != 0) break;
+        f = f + k;
+    }
+    while (f != l && !p(source(f))) f = successor(f);
+    return f;
+}
+
+template<typename I, typename P>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P))
+I find_if_not_lanes(I f, I l, P p)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    typedef DistanceType(I) N;
+    const N k = N(quantifier_lanes);
+    while (l - f >= k) {
+        int c = 0;
+        for (N i(0); i < k; i = successor(i))
+            if (!p(source(f + i))) c = successor(c);
+        if (c != 0) break;
+        f = f + k;
+    }
+    while (f != l && p(source(f))) f = successor(f);
+    return f;
+}
+
+template<typename I, typename P>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P))
+DistanceType(I) count_if_lanes(I f, I l, P p)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    typedef DistanceType(I) N;
+    const N k = N(quantifier_lanes);
+    N n(0);
+    while (l - f >= k) {
+        int c = 0;
+        for (N i(0); i < k; i = successor(i))
+            if (p(source(f + i))) c = successor(c);
+        n = n + N(c);
+        f = f + k;
+    }
+    while (f != l) {
+        if (p(source(f))) n = successor(n);
+        f = successor(f);
+    }
+    return n;
+}
+
+template<typename I>
+    requires(Readable(I) && Iterator(I))
+I find(I f, I l, const ValueType(I)& x, contiguous_storage_tag)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return find_if_lanes(f, l, equal_to_x<ValueType(I)>(x));
+}
+
+template<typename I>
+    requires(Readable(I) && Iterator(I))
+I find_not(I f, I l, const ValueType(I)& x, contiguous_storage_tag)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return find_if_not_lanes(f, l, equal_to_x<ValueType(I)>(x));
+}
+
+template<typename I, typename P>
+    requires(Readable(I) && Iterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P))
+I find_if(I f, I l, P p, contiguous_storage_tag, comparison_predicate_tag)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return find_if_lanes(f, l, p);
+}
+
+template<typename I, typename P>
+    requires(Readable(I) && Iterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P))
+I find_if_not(I f, I l, P p, contiguous_storage_tag, comparison_predicate_tag)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return find_if_not_lanes(f, l, p);
+}
+
+template<typename I, typename P, typename J>
+    requires(Readable(I) && Iterator(I) &&
+        UnaryPredicate(P) && Iterator(J) &&
+        ValueType(I) == Domain(P))
+J count_if(I f, I l, P p, J j, contiguous_storage_tag, comparison_predicate_tag)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return j + DistanceType(J)(count_if_lanes(f, l, p));
+}
+
+template<typename I, typename P, typename J>
+    requires(Readable(I) && Iterator(I) &&
+        UnaryPredicate(P) && Iterator(J) &&
+        ValueType(I) == Domain(P))
+J count_if_not(I f, I l, P p, J j, contiguous_storage_tag, comparison_predicate_tag)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return j + DistanceType(J)((l - f) - count_if_lanes(f, l, p));
+}
+
+template<typename I, typename J>
+    requires(Readable(I) && Iterator(I) && Iterator(J))
+J count(I f, I l, const ValueType(I)& x, J j, contiguous_storage_tag)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return j + DistanceType(J)(count_if_lanes(f, l, equal_to_x<ValueType(I)>(x)));
+}
+
+template<typename I, typename J>
+    requires(Readable(I) && Iterator(I) && Iterator(J))
+J count_not(I f, I l, const ValueType(I)& x, J j, contiguous_storage_tag)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, l)$
+    return j + DistanceType(J)((l - f) -
+                               count_if_lanes(f, l, equal_to_x<ValueType(I)>(x)));
+}
+
 template<typename I, typename Op, typename F>
     requires(Iterator(I) && BinaryOperation(Op) && 
         UnaryFunction(F) &&
@@ -1884,6 +2306,13 @@ struct lower_bound_predicate
     bool operator()(const T& x) { return !r(x, a); }
 };
 
+template<typename T>
+    requires(TotallyOrdered(T))
+struct predicate_concept< lower_bound_predicate< less<T> > >
+{
+    typedef comparison_predicate_tag concept;
+};
+
 template<typename I, typename R>
     requires(Readable(I) && ForwardIterator(I) &&
         Relation(R) && ValueType(I) == Domain(R))
@@ -1907,6 +2336,13 @@ struct upper_bound_predicate
     bool operator()(const T& x) { return r(a, x); }
 };
 
+template<typename T>
+    requires(TotallyOrdered(T))
+struct predicate_concept< upper_bound_predicate< less<T> > >
+{
+    typedef comparison_predicate_tag concept;
+};
+
 template<typename I, typename R>
     requires(Readable(I) && ForwardIterator(I) &&
         Relation(R) && ValueType(I) == Domain(R))
@@ -4051,7 +4487,14 @@ I partition_single_cycle(I f, I l, P p)
             return f;
         }
         sink(l) = source(f);
-        l = find_backward_if_not_unguarded(l, p);
+        // $(f, l)$ may hold no element not satisfying $p$; then the hole
+        // at $f$ is the partition point
+        l = find_backward_if_not(successor(f), l, p);
+        if (l == successor(f)) {
+            sink(f) = tmp;
+            return f;
+        }
+        l = predecessor(l);
     }
 }
 
@@ -4308,6 +4751,170 @@ Domain(Op) reduce_balanced(I f, I l, Op op, const Domain(Op)& z)
 }
 
 
+// Parallel balanced reduction
+
+// The tree built by $\func{reduce\_balanced}$ over $m$ elements other than
+// $z$ depends only on $m$: element $j$ of them lies in the blocks
+// $[k 2^i, (k+1) 2^i)$ containing $j$, each reduced as
+// $op(\text{first half}, \text{second half})$. $\func{reduce\_balanced\_n}$
+// with $threads > 1$ cuts the range into equal parts; a first pass counts
+// the elements other than $z$ in each part, which tells every thread where
+// its elements lie among all of them. Each thread then reduces the largest
+// whole blocks in its part with its own $\func{counter\_machine}$, and the
+// blocks of all the parts are added, in order and each at its own level,
+// to a last $\func{counter\_machine}$. Every application of $op$ is thus
+// the one the sequential procedure makes, and the result is identical to
+// it even when $op$ is not associative, as for floating-point addition
+
+const int reduce_balanced_grain = 1 << 14;
+
+template<typename N>
+    requires(Integer(N))
+int reduce_balanced_threads(N n, int threads)
+{
+    // Precondition: $threads > 0$
+    N t = n / N(reduce_balanced_grain);
+    return t < N(threads) ? (t == N(0) ? 1 : int(t)) : threads;
+}
+
+template<typename Op>
+    requires(BinaryOperation(Op))
+void add_to_counter_at(counter_machine<Op>& c, int i, const Domain(Op)& x)
+{
+    // Precondition: $x$ is the reduction of a block of $2^i$ elements
+    //     and the slots of $c$ below $i$ are empty
+    typedef Domain(Op) T;
+    while (c.l - c.f < i) {
+        sink(c.l) = c.z;
+        c.l = successor(c.l);
+    }
+    T tmp = add_to_counter(c.f + i, c.l, c.op, x, c.z);
+    if (tmp != c.z) {
+        sink(c.l) = tmp;
+        c.l = successor(c.l);
+    }
+}
+
+template<typename I>
+    requires(Readable(I) && RandomAccessIterator(I))
+struct count_not_worker
+{
+    typedef DistanceType(I) N;
+    I f;
+    N n;
+    ValueType(I) z;
+    pointer(N) r;
+    count_not_worker(I f, N n, const ValueType(I)& z, pointer(N) r)
+        : f(f), n(n), z(z), r(r) { }
+    void operator()()
+    {
+        sink(r) = count_not(f, f + n, z);
+    }
+};
+
+template<typename I, typename Op>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        BinaryOperation(Op) && ValueType(I) == Domain(Op))
+struct reduce_balanced_worker
+{
+    // Reduces a part whose first element other than $z$ is the $j$-th
+    // of them and which holds $m$ of them: $r[i]$ receives the block of
+    // $2^i$ elements starting the part, if there is one, for increasing
+    // $i$ while $j$ is a multiple of $2^i$; $r[64 + i]$ receives slot $i$
+    // of the $\func{counter\_machine}$ of the elements left
+    typedef DistanceType(I) N;
+    typedef Domain(Op) T;
+    I f;
+    N n;
+    N j;
+    N m;
+    Op op;
+    T z;
+    pointer(T) r;
+    reduce_balanced_worker(I f, N n, N j, N m, Op op, const T& z, pointer(T) r)
+        : f(f), n(n), j(j), m(m), op(op), z(z), r(r) { }
+    void operator()()
+    {
+        I l = f + n;
+        N b = j + m;
+        counter_machine<Op> c(op, z);
+        for (int i = 0; i < 128; i = successor(i)) r[i] = z;
+        while (!zero(j)) {
+            N k = j & (N(0) - j);
+            if (b - j < k) break;
+            j = j + k;
+            while (!zero(k)) {
+                if (source(f) != z) {
+                    c(source(f));
+                    k = predecessor(k);
+                }
+                f = successor(f);
+            }
+            int i = int(c.l - c.f) - 1;
+            r[i] = c.f[i];
+            c.l = c.f;
+        }
+        while (f != l) {
+            c(source(f));
+            f = successor(f);
+        }
+        for (int i = 0; i < int(c.l - c.f); i = successor(i))
+            r[64 + i] = c.f[i];
+    }
+};
+
+template<typename I, typename Op>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        BinaryOperation(Op) && ValueType(I) == Domain(Op))
+Domain(Op) reduce_balanced_n(I f, DistanceType(I) n, Op op,
+                             const Domain(Op)& z, int threads)
+{
+    // Precondition: $\property{readable\_counted\_range}(f, n) \wedge n < 2^{64}$
+    // Precondition: $\property{partially\_associative}(op) \wedge threads > 0$
+    // Precondition: no reduction of two or more elements equals $z$
+    // Postcondition: returns $\func{reduce\_balanced}(f, f + n, op, z)$
+    typedef DistanceType(I) N;
+    typedef Domain(Op) T;
+    typedef count_not_worker<I> C;
+    typedef reduce_balanced_worker<I, Op> W;
+    threads = reduce_balanced_threads(n, threads);
+    if (threads == 1) return reduce_balanced(f, f + n, op, z);
+    pointer(std::thread) t = new std::thread[threads];
+    pointer(N) m = new N[threads];
+    pointer(T) r = new T[128 * threads];
+    N k = n / N(threads);
+    for (int u = 0; u < threads; u = successor(u)) {
+        N i = N(u) * k;
+        N h = u == threads - 1 ? n - i : k;
+        t[u] = std::thread(C(f + i, h, z, &m[u]));
+    }
+    for (int u = 0; u < threads; u = successor(u))
+        t[u].join();
+    N j(0);
+    for (int u = 0; u < threads; u = successor(u)) {
+        N i = N(u) * k;
+        N h = u == threads - 1 ? n - i : k;
+        t[u] = std::thread(W(f + i, h, j, m[u], op, z, &r[128 * u]));
+        j = j + m[u];
+    }
+    for (int u = 0; u < threads; u = successor(u))
+        t[u].join();
+    counter_machine<Op> c(op, z);
+    for (int u = 0; u < threads; u = successor(u)) {
+        pointer(T) r_u = &r[128 * u];
+        for (int i = 0; i < 64; i = successor(i))
+            if (r_u[i] != z) add_to_counter_at(c, i, r_u[i]);
+        for (int i = 63; i >= 0; i = predecessor(i))
+            if (r_u[64 + i] != z) add_to_counter_at(c, i, r_u[64 + i]);
+    }
+    delete[] r;
+    delete[] m;
+    delete[] t;
+    transpose_operation<Op> t_op(op);
+    return reduce_nonzeroes(c.f, c.l, t_op, z);
+}
+
+
 template<typename I, typename P>
     requires(ForwardIterator(I) && UnaryPredicate(P) &&
         ValueType(I) == Domain(P))
@@ -6446,6 +7053,7 @@ struct array
     ~array()
     {
         erase_all(sink(this));
+        deallocate_array(p); // an empty array may still own reserved storage
     }
 };
 
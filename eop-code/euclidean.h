@@ -0,0 +1,583 @@
+// euclidean.h
+
+// Copyright (c) 2009 Alexander Stepanov and Paul McJones
+//
+// Permission to use, copy, modify, distribute and sell this software
+// and its documentation for any purpose is hereby granted without
+// fee, provided that the above copyright notice appear in all copies
+// and that both that copyright notice and this permission notice
+// appear in supporting documentation. The authors make no
+// representations about the suitability of this software for any
+// purpose. It is provided "as is" without express or implied
+// warranty.
+
+
+// Batch gcd extending Chapter 5 of
+// Elements of Programming
+// by Alexander Stepanov and Paul McJones
+// Addison-Wesley Professional, 2009
+
+
+#ifndef EOP_EUCLIDEAN
+#define EOP_EUCLIDEAN
+
+
+#include "intrinsics.h"
+#include "type_functions.h"
+#include "eop.h"
+#include "multiprecision.h"
+
+
+// Binary gcd in lanes
+
+// $\func{binary\_gcd\_lanes}$ runs $\func{binary\_gcd\_nonnegative}$ on $k$
+// pairs in lockstep. There is no vector count-trailing-zeros instruction,
+// so after the factors of two are stripped once per lane, each step does
+// one bit of work in every lane: an odd $b$ is replaced by $|a - b|$ and
+// $a$ by $\min(a, b)$, then $b$ is halved. The step is the same in every
+// lane, with masks instead of branches, so the compiler can vectorize it;
+// a lane whose $b$ has reached 0 is finished and stays so.
+// The lanes are copied to local arrays so that the compiler can see that
+// $a$ and $b$ do not overlap.
+
+const int gcd_lanes = 16;
+const int gcd_lanes_steps = 8; // steps between tests for completion
+
+// 64-bit lanes only pay off where vectors compare 64-bit integers
+// (AVX-512); elsewhere $\func{gcd\_n}$ takes 64-bit pairs one at a time
+#if defined(__AVX512VL__)
+const bool gcd_lanes_wide = true;
+#else
+const bool gcd_lanes_wide = false;
+#endif
+
+template<int k, typename U>
+    requires(UnsignedInteger(U))
+void binary_gcd_lanes(array_k<k, U>& a, array_k<k, U>& b)
+{
+    // Postcondition: $a[i]$ is the gcd of the original $a[i]$ and $b[i]$,
+    //     or 0 if both were 0
+    array_k<k, U> x, y;
+    array_k<k, int> d;
+    for (int i = 0; i < k; ++i) {
+        x[i] = a[i];
+        y[i] = b[i];
+        d[i] = 0;
+        if (x[i] == U(0)) { x[i] = y[i]; y[i] = U(0); }
+        if (y[i] == U(0)) continue;
+        d[i] = count_trailing_zeros(U(x[i] | y[i]));
+        x[i] = x[i] >> count_trailing_zeros(x[i]);
+        y[i] = y[i] >> count_trailing_zeros(y[i]);
+    }
+    while (true) {
+        U z(0);
+        for (int i = 0; i < k; ++i) z = z | y[i];
+        if (z == U(0)) break;
+        for (int s = 0; s < gcd_lanes_steps; ++s)
+            for (int i = 0; i < k; ++i) { // no branches: vectorizable
+                U u = x[i];
+                U v = y[i];
+                U o = U(0) - (v & U(1));  // all ones if $v$ is odd
+                U c = U(0) - U(v < u);    // all ones if $v < u$
+                U m = o & c;
+                x[i] = (m & v) | (~m & u);
+                U e = (c & (u - v)) | (~c & (v - u));
+                y[i] = ((o & e) | (~o & v)) >> 1;
+            }
+    }
+    for (int i = 0; i < k; ++i) a[i] = x[i] << d[i];
+}
+
+template<typename T>
+    requires(Integer(T))
+DistanceType(T) magnitude(T x)
+{
+    // Postcondition: $|x|$ as the unsigned type of the same size
+    typedef DistanceType(T) U;
+    return x < T(0) ? U(0) - U(x) : U(x);
+}
+
+
+// Batch gcd
+
+// $\func{gcd\_n}$ computes the gcds of corresponding elements of two
+// counted ranges, and $\func{reduce\_gcd\_n}$ the gcd of all the elements of
+// one, for the built-in integers. Both return nonnegative gcds, like
+// $\func{binary\_gcd}$, and work $\func{gcd\_lanes}$ elements at a time
+// when the lanes pay off.
+// $\func{reduce\_gcd\_n}$ keeps one running gcd per lane and stops as soon
+// as all of them are 1, which for random data happens after a few
+// elements.
+
+template<typename I0, typename I1, typename O>
+    requires(Readable(I0) && Iterator(I0) && Integer(ValueType(I0)) &&
+        Readable(I1) && Iterator(I1) && ValueType(I1) == ValueType(I0) &&
+        Writable(O) && Iterator(O) && ValueType(O) == ValueType(I0))
+O gcd_n(I0 f0, DistanceType(I0) n, I1 f1, O f_o)
+{
+    // Precondition: $\func{readable\_weak\_range}(f_0, n) \wedge
+    //                \func{readable\_weak\_range}(f_1, n) \wedge
+    //                \func{writable\_weak\_range}(f_o, n)$
+    // Precondition: the gcds are representable in $\func{ValueType}(I_0)$
+    // Postcondition: $\func{source}(f_o + i) =
+    //     \func{binary\_gcd}(\func{source}(f_0 + i), \func{source}(f_1 + i))$
+    typedef ValueType(I0) T;
+    typedef DistanceType(T) U;
+    const int k = gcd_lanes;
+    array_k<k, U> a, b;
+    while ((sizeof(U) <= 4 || gcd_lanes_wide) && !(n < DistanceType(I0)(k))) {
+        for (int i = 0; i < k; ++i) {
+            a[i] = magnitude(source(f0)); f0 = successor(f0);
+            b[i] = magnitude(source(f1)); f1 = successor(f1);
+        }
+        binary_gcd_lanes(a, b);
+        for (int i = 0; i < k; ++i) {
+            sink(f_o) = T(a[i]); f_o = successor(f_o);
+        }
+        n = n - DistanceType(I0)(k);
+    }
+    while (count_down(n)) {
+        sink(f_o) = T(binary_gcd_nonnegative(magnitude(source(f0)),
+                                             magnitude(source(f1))));
+        f0 = successor(f0); f1 = successor(f1); f_o = successor(f_o);
+    }
+    return f_o;
+}
+
+template<typename I>
+    requires(Readable(I) && Iterator(I) && Integer(ValueType(I)))
+ValueType(I) reduce_gcd_n(I f, DistanceType(I) n)
+{
+    // Precondition: $\func{readable\_weak\_range}(f, n)$
+    // Precondition: the gcd is representable in $\func{ValueType}(I)$
+    // Postcondition: returns the nonnegative gcd of the elements,
+    //     or 0 if they are all 0 or $n = 0$
+    typedef ValueType(I) T;
+    typedef DistanceType(T) U;
+    const int k = gcd_lanes;
+    array_k<k, U> a, b;
+    for (int i = 0; i < k; ++i) a[i] = U(0);
+    while ((sizeof(U) <= 4 || gcd_lanes_wide) && !(n < DistanceType(I)(k))) {
+        for (int i = 0; i < k; ++i) {
+            b[i] = magnitude(source(f)); f = successor(f);
+        }
+        binary_gcd_lanes(a, b);
+        n = n - DistanceType(I)(k);
+        U c(0);
+        for (int i = 0; i < k; ++i) c = c | (a[i] ^ U(1));
+        if (c == U(0)) return T(1);
+    }
+    U r(0);
+    for (int i = 0; i < k; ++i) r = binary_gcd_nonnegative(r, a[i]);
+    while (r != U(1) && count_down(n)) {
+        r = binary_gcd_nonnegative(r, magnitude(source(f)));
+        f = successor(f);
+    }
+    return T(r);
+}
+
+
+// Parallel batch gcd
+
+// With $threads > 1$ the ranges are cut into equal parts, one per thread,
+// but no part is made smaller than $\func{gcd\_grain}$ elements, below
+// which starting a thread costs more than it saves.
+
+const int gcd_grain = 1 << 14;
+
+template<typename N>
+    requires(Integer(N))
+int gcd_threads(N n, int threads)
+{
+    // Precondition: $threads > 0$
+    N t = n / N(gcd_grain);
+    return t < N(threads) ? (t == N(0) ? 1 : int(t)) : threads;
+}
+
+template<typename I0, typename I1, typename O>
+    requires(Readable(I0) && RandomAccessIterator(I0) &&
+        Readable(I1) && RandomAccessIterator(I1) &&
+        Writable(O) && RandomAccessIterator(O))
+struct gcd_n_worker
+{
+    typedef DistanceType(I0) N;
+    I0 f0;
+    N n;
+    I1 f1;
+    O f_o;
+    gcd_n_worker(I0 f0, N n, I1 f1, O f_o)
+        : f0(f0), n(n), f1(f1), f_o(f_o) { }
+    void operator()()
+    {
+        gcd_n(f0, n, f1, f_o);
+    }
+};
+
+template<typename I0, typename I1, typename O>
+    requires(Readable(I0) && RandomAccessIterator(I0) &&
+        Integer(ValueType(I0)) &&
+        Readable(I1) && RandomAccessIterator(I1) &&
+        ValueType(I1) == ValueType(I0) &&
+        Writable(O) && RandomAccessIterator(O) &&
+        ValueType(O) == ValueType(I0))
+O gcd_n(I0 f0, DistanceType(I0) n, I1 f1, O f_o, int threads)
+{
+    // Precondition: as for the sequential $\func{gcd\_n}$, and $threads > 0$
+    typedef DistanceType(I0) N;
+    typedef gcd_n_worker<I0, I1, O> W;
+    threads = gcd_threads(n, threads);
+    if (threads == 1) return gcd_n(f0, n, f1, f_o);
+    pointer(std::thread) t = new std::thread[threads];
+    N m = n / N(threads);
+    for (int u = 0; u < threads; u = successor(u)) {
+        N i = N(u) * m;
+        N j = u == threads - 1 ? n - i : m;
+        t[u] = std::thread(W(f0 + i, j, f1 + i, f_o + i));
+    }
+    for (int u = 0; u < threads; u = successor(u))
+        t[u].join();
+    delete[] t;
+    return f_o + n;
+}
+
+template<typename I>
+    requires(Readable(I) && RandomAccessIterator(I) && Integer(ValueType(I)))
+struct reduce_gcd_n_worker
+{
+    typedef DistanceType(I) N;
+    I f;
+    N n;
+    pointer(ValueType(I)) r;
+    reduce_gcd_n_worker(I f, N n, pointer(ValueType(I)) r)
+        : f(f), n(n), r(r) { }
+    void operator()()
+    {
+        sink(r) = reduce_gcd_n(f, n);
+    }
+};
+
+template<typename I>
+    requires(Readable(I) && RandomAccessIterator(I) && Integer(ValueType(I)))
+ValueType(I) reduce_gcd_n(I f, DistanceType(I) n, int threads)
+{
+    // Precondition: as for the sequential $\func{reduce\_gcd\_n}$,
+    //     and $threads > 0$
+    typedef DistanceType(I) N;
+    typedef ValueType(I) T;
+    typedef reduce_gcd_n_worker<I> W;
+    threads = gcd_threads(n, threads);
+    if (threads == 1) return reduce_gcd_n(f, n);
+    pointer(std::thread) t = new std::thread[threads];
+    array<T> r(threads, threads, T(0));
+    N m = n / N(threads);
+    for (int u = 0; u < threads; u = successor(u)) {
+        N i = N(u) * m;
+        N j = u == threads - 1 ? n - i : m;
+        t[u] = std::thread(W(f + i, j, &r[u]));
+    }
+    for (int u = 0; u < threads; u = successor(u))
+        t[u].join();
+    delete[] t;
+    return reduce_gcd_n(begin(r), threads);
+}
+
+
+// Extended gcd
+
+// $\func{extended\_gcd}$ follows the remainder sequence of $\func{gcd}$ and
+// carries along the coefficients expressing each remainder as a linear
+// combination of $a$ and $b$; $/$ is the Euclidean quotient, so that
+// $a - (a / b) b = \func{remainder}(a, b)$
+
+template<typename T>
+    requires(EuclideanDomain(T))
+triple<T, T, T> extended_gcd(T a, T b)
+{
+    // Precondition: $\neg(a = 0 \wedge b = 0)$
+    // Postcondition: returns $(g, x, y)$ where $g$ is a gcd of $a$ and $b$
+    //     and $g = a x + b y$
+    T x0(1);
+    T x1(0);
+    T y0(0);
+    T y1(1);
+    while (b != T(0)) {
+        T q = a / b;
+        T t = a - q * b;  a = b;   b = t;
+        t = x0 - q * x1;  x0 = x1; x1 = t;
+        t = y0 - q * y1;  y0 = y1; y1 = t;
+    }
+    return triple<T, T, T>(a, x0, y0);
+}
+
+template<typename T>
+    requires(Integer(T))
+T multiplicative_inverse_modulo(T a, T m)
+{
+    // Precondition: $m > 1 \wedge \gcd(a, m) = 1$
+    // Postcondition: returns $x$ where $0 \leq x < m \wedge a x \equiv 1 \pmod{m}$
+    a = a % m;
+    if (a < T(0)) a = a + m;
+    T x = extended_gcd(a, m).m1;       // $-m < x < m$
+    if (x < T(0)) x = x + m;
+    return x;
+}
+
+
+// Lehmer's gcd for big integers
+
+// Euclid's algorithm makes a full-precision division for every quotient,
+// although most quotients fit in a few bits. Lehmer's algorithm runs it on
+// the leading $\func{lehmer\_bits}$ bits of both numbers instead, composing
+// the steps into a matrix of single-limb cofactors while the quotients are
+// certain to be those of the full numbers (Knuth, vol. 2, 4.5.2, Algorithm
+// L), and then applies the matrix with four multiplications by a limb.
+// A full-precision division is only needed when the leading bits do not
+// determine even one quotient.
+
+const int lehmer_bits = 62;
+
+int bit_length(const big_integer& x)
+{
+    return x.n == 0 ? 0 : x.n * limb_bits - limbs_leading_zeros(x.d[x.n - 1]);
+}
+
+limb leading_bits(const big_integer& x, int k)
+{
+    // Precondition: $k \geq 0 \wedge |x| < 2^{k + 64}$
+    // Postcondition: returns $\lfloor |x| / 2^k \rfloor$
+    int i = k / limb_bits;
+    int j = k % limb_bits;
+    if (i >= x.n) return 0;
+    limb r = x.d[i] >> j;
+    if (j != 0 && successor(i) < x.n) r = r | (x.d[successor(i)] << (limb_bits - j));
+    return r;
+}
+
+bool lehmer_matrix(limb a, limb b,
+                   long long& p, long long& q, long long& r, long long& s)
+{
+    // Precondition: $a \geq b \wedge a < 2^{\func{lehmer\_bits}}$
+    // Postcondition: $\left(\begin{smallmatrix}p & q \\ r & s\end{smallmatrix}\right)$
+    //     is the product of the Euclid steps on any $a', b'$ with leading
+    //     bits $a, b$; returns false if there are none
+    long long x(a);
+    long long y(b);
+    p = 1; q = 0; r = 0; s = 1;
+    while (y + r != 0 && y + s != 0) {
+        long long k = (x + p) / (y + r);
+        if (k != (x + q) / (y + s)) break;
+        long long t = p - k * r; p = r; r = t;
+        t = q - k * s;           q = s; s = t;
+        t = x - k * y;           x = y; y = t;
+    }
+    return q != 0;
+}
+
+void lehmer_gcd_nonnegative(big_integer& a, big_integer& b,
+                            pointer(big_integer) u, pointer(big_integer) v)
+{
+    // Precondition: $a \geq b \geq 0 \wedge a > 0$
+    // Postcondition: $a$ is the gcd of $a$ and $b$, and $b = 0$
+    // Postcondition: unless $u = 0$, $\func{source}(u)$ and $\func{source}(v)$
+    //     are transformed as $a$ and $b$ are: if they were the coefficients of
+    //     some $c$ in $a$ and $b$, $\func{source}(u)$ is its coefficient in the gcd
+    typedef big_integer I;
+    while (!zero(b)) {
+        if (a.n > 1) {
+            int k = bit_length(a) - lehmer_bits;
+            long long p, q, r, s;
+            if (lehmer_matrix(leading_bits(a, k), leading_bits(b, k), p, q, r, s)) {
+                I t = I(p) * a + I(q) * b;
+                b = I(r) * a + I(s) * b;
+                a = t;
+                if (u != 0) {
+                    t = I(p) * source(u) + I(q) * source(v);
+                    sink(v) = I(r) * source(u) + I(s) * source(v);
+                    sink(u) = t;
+                }
+                continue;
+            }
+        }
+        pair<I, I> t = quotient_remainder(a, b);
+        a = b;
+        b = t.m1;
+        if (u != 0) {
+            I w = source(u) - t.m0 * source(v);
+            sink(u) = source(v);
+            sink(v) = w;
+        }
+    }
+}
+
+// For big integers $\func{gcd}$ and $\func{extended\_gcd}$ use Lehmer's
+// algorithm and return the nonnegative gcd
+
+template<>
+big_integer gcd<big_integer>(big_integer a, big_integer b)
+{
+    // Precondition: $\neg(a = 0 \wedge b = 0)$
+    a.s = false;
+    b.s = false;
+    if (a < b) swap(a, b);
+    lehmer_gcd_nonnegative(a, b, 0, 0);
+    return a;
+}
+
+template<>
+triple<big_integer, big_integer, big_integer>
+extended_gcd<big_integer>(big_integer a, big_integer b)
+{
+    // Precondition: $\neg(a = 0 \wedge b = 0)$
+    typedef big_integer I;
+    typedef triple<I, I, I> T;
+    I x(a);
+    I y(b);
+    x.s = false;
+    y.s = false;
+    bool c = x < y;
+    if (c) swap(x, y);
+    I u(1);
+    I v(0);
+    lehmer_gcd_nonnegative(x, y, &u, &v);
+    // $x = u |a'| + w |b'|$ where $a'$ is the larger of $a$ and $b$
+    I a1 = c ? b : a;
+    I b1 = c ? a : b;
+    if (a1.s) u = -u;
+    I w = zero(b1) ? I(0) : (x - u * a1) / b1;
+    return c ? T(x, w, u) : T(x, u, w);
+}
+
+
+// Division by an invariant integer
+
+// When a loop divides by the same $d$ every time, the division can be
+// replaced by a multiplication by a precomputed reciprocal and a shift
+// (Granlund and Montgomery, 1994, in the form used by libdivide). For an
+// $n$-bit $d$ that is not a power of two, with $l = \lfloor \log_2 d \rfloor$,
+// the multiplier is $m = \lfloor 2^{n + l} / d \rfloor + 1$ truncated to
+// $n$ bits; when the rounding error is too large for $n$ bits, one more
+// bit of $m$ is needed and is added back with $\func{add}$.
+// $\func{quotient\_remainder\_invariant}$ and $\func{remainder\_invariant}$
+// model the $quo\_rem$ and $rem$ arguments of $\func{quotient\_remainder}$
+// and $\func{remainder}$ for that one divisor.
+
+unsigned multiply_high(unsigned x, unsigned y)
+{
+    return unsigned((unsigned long long)(x) * y >> 32);
+}
+
+unsigned long multiply_high(unsigned long x, unsigned long y)
+{
+    return (unsigned long)((unsigned __int128)(x) * y >> 64);
+}
+
+unsigned long long multiply_high(unsigned long long x, unsigned long long y)
+{
+    return (unsigned long long)((unsigned __int128)(x) * y >> 64);
+}
+
+template<typename T>
+    requires(Integer(T))
+struct invariant_divisor
+{
+    typedef DistanceType(T) U;
+    U d;
+    U m;                       // 0 when $d$ is a power of two
+    int s;                     // final shift
+    bool add;                  // $m$ has an implicit leading bit
+    invariant_divisor() { }
+    invariant_divisor(T x) : d(U(x)), m(0), s(0), add(false)
+    {
+        // Precondition: $x > 0$
+        const int n = int(sizeof(U)) * 8;
+        int l = n - 1;
+        while ((d >> l) == U(0)) l = predecessor(l);
+        s = l;
+        if ((d & (d - U(1))) == U(0)) return;
+        // $2^{n + l} / d$, one bit at a time, with $2^l < d < 2^{l + 1}$
+        U q(0);
+        U r = U(1) << l;       // $2^{n + l} = (2^l) 2^n$; $2^l < d$
+        for (int i = 0; i < n; i = successor(i)) {
+            bool c = (r >> (n - 1)) != U(0);
+            r = r << 1;
+            q = q << 1;
+            if (c || !(r < d)) { r = r - d; q = q | U(1); }
+        }
+        if (d - r < (U(1) << l)) {
+            m = q + U(1);
+        } else {
+            // $\lfloor 2^{n + l + 1} / d \rfloor + 1$, without its top bit
+            U t = r + r;
+            q = q + q;
+            if (!(t < d) || t < r) q = q + U(1);
+            m = q + U(1);
+            add = true;
+        }
+    }
+    T quotient(T a) const
+    {
+        // Precondition: $a \geq 0$
+        U x(a);
+        if (m == U(0)) return T(x >> s);
+        U h = multiply_high(m, x);
+        if (!add) return T(h >> s);
+        return T((((x - h) >> 1) + h) >> s);
+    }
+};
+
+template<typename T>
+    requires(Integer(T))
+struct quotient_remainder_invariant
+{
+    invariant_divisor<T> d;
+    quotient_remainder_invariant(T d) : d(d) { }
+    pair<QuotientType(T), T> operator()(T a, T b) const
+    {
+        // Precondition: $a \geq 0 \wedge b$ is the divisor of construction
+        T q = d.quotient(a);
+        return pair<QuotientType(T), T>(q, a - q * b);
+    }
+};
+
+template<typename T>
+    requires(Integer(T))
+struct input_type<quotient_remainder_invariant<T>, 0>
+{
+    typedef T type;
+};
+
+template<typename T>
+    requires(Integer(T))
+struct codomain_type< quotient_remainder_invariant<T> >
+{
+    typedef pair<QuotientType(T), T> type;
+};
+
+template<typename T>
+    requires(Integer(T))
+struct remainder_invariant
+{
+    invariant_divisor<T> d;
+    remainder_invariant(T d) : d(d) { }
+    T operator()(T a, T b) const
+    {
+        // Precondition: $a \geq 0 \wedge b$ is the divisor of construction
+        return a - d.quotient(a) * b;
+    }
+};
+
+template<typename T>
+    requires(Integer(T))
+struct input_type<remainder_invariant<T>, 0>
+{
+    typedef T type;
+};
+
+template<typename T>
+    requires(Integer(T))
+struct codomain_type< remainder_invariant<T> >
+{
+    typedef T type;
+};
+
+#endif // EOP_EUCLIDEAN
@@ -23,6 +23,9 @@
 
 
 #include <new> // placement operator new
+#include <atomic> // std::atomic
+#include <mutex> // std::mutex, std::lock_guard
+#include <thread> // std::thread
 
 
 // As explained in Appendix B.2, to allow the language defined in Appendix B.1
@@ -94,6 +97,17 @@ void destroy(T& p, U& finalizer)
 }
 
 
+// Prefetching (not in Appendix B.2)
+
+template<typename T>
+void prefetch(pointer(const T) x)
+{
+    // Postcondition: none; asks for the cache line holding $x$ to be read
+    //     ahead of use
+    __builtin_prefetch(x);
+}
+
+
 // Type functions: see type_functions.h
 
 #endif // EOP_INTRINSICS
@@ -0,0 +1,288 @@
+// matrices.h
+
+// Copyright (c) 2009 Alexander Stepanov and Paul McJones
+//
+// Permission to use, copy, modify, distribute and sell this software
+// and its documentation for any purpose is hereby granted without
+// fee, provided that the above copyright notice appear in all copies
+// and that both that copyright notice and this permission notice
+// appear in supporting documentation. The authors make no
+// representations about the suitability of this software for any
+// purpose. It is provided "as is" without express or implied
+// warranty.
+
+
+// Matrices over semirings extending Chapter 3 of
+// Elements of Programming
+// by Alexander Stepanov and Paul McJones
+// Addison-Wesley Professional, 2009
+
+
+#ifndef EOP_MATRICES
+#define EOP_MATRICES
+
+
+#include "intrinsics.h"
+#include "type_functions.h"
+#include "eop.h"
+
+#include <cstdlib> // malloc, free
+#include <limits> // numeric_limits
+#include <new> // bad_alloc
+
+
+// Semirings
+
+// A semiring is a type with static procedures $add$ and $multiply$ and
+// their identity elements $zero$ and $one$, where $multiply$ distributes
+// over $add$ and $zero$ annihilates. Matrix multiplication over any
+// semiring is associative, so $\func{power}$ applies to its matrices:
+// with $\func{arithmetic\_semiring}$ they step linear recurrences, with
+// $\func{tropical\_semiring}$ the $n$-th power of a weight matrix holds
+// the shortest paths of at most $n$ edges, and with
+// $\func{boolean\_semiring}$ it holds reachability in exactly $n$ steps
+
+template<typename T>
+    requires(ArithmeticSemiring(T))
+struct arithmetic_semiring
+{
+    typedef T value_type;
+    static T zero() { return T(0); }
+    static T one() { return T(1); }
+    static T add(const T& x, const T& y) { return x + y; }
+    static T multiply(const T& x, const T& y) { return x * y; }
+};
+
+template<typename T>
+    requires(OrderedAdditiveGroup(T))
+struct tropical_semiring
+{
+    // $(\min, +)$ with $zero = \infty$; for integral $T$, $\infty$ is half
+    // the largest value, so that a sum of two never overflows
+    // Precondition: entries are at least $-\infty / 2$
+    typedef T value_type;
+    static T zero()
+    {
+        return std::numeric_limits<T>::has_infinity ?
+            std::numeric_limits<T>::infinity() :
+            std::numeric_limits<T>::max() / T(2);
+    }
+    static T one() { return T(0); }
+    static T add(const T& x, const T& y) { return y < x ? y : x; }
+    static T multiply(const T& x, const T& y)
+    {
+        T z = x + y;
+        return zero() < z ? zero() : z;
+    }
+};
+
+struct boolean_semiring
+{
+    typedef bool value_type;
+    static bool zero() { return false; }
+    static bool one() { return true; }
+    static bool add(bool x, bool y) { return x | y; }
+    static bool multiply(bool x, bool y) { return x & y; }
+};
+
+
+// type matrix
+// model Regular(matrix) && MultiplicativeSemigroup(matrix)
+
+// Square matrices, stored by rows. A positive $n$ fixes the dimension at
+// compile time, so the loops of the multiplication have constant bounds;
+// with $n = 0$ the dimension is given at construction
+
+const int matrix_block = 64;
+
+int matrix_entries(int k)
+{
+    return k == 0 ? 1 : k * k; // a dimension of 0 still gets an entry
+}
+
+template<typename S>
+    requires(Semiring(S))
+pointer(typename S::value_type) allocate_matrix(int k)
+{
+    // Postcondition: the $\func{matrix\_entries}(k)$ entries are constructed
+    //     equal to $zero$
+    typedef typename S::value_type T;
+    typedef pointer(T) P;
+    int m = matrix_entries(k);
+    P p = P(malloc(m * sizeof(T)));
+    if (p == 0) throw std::bad_alloc();
+    for (int i = 0; i < m; i = successor(i)) construct(p[i], S::zero());
+    return p;
+}
+
+template<typename S>
+    requires(Semiring(S))
+void deallocate_matrix(pointer(typename S::value_type) p, int k)
+{
+    // Precondition: $p$ was returned by $\func{allocate\_matrix}<S>(k)$
+    int m = matrix_entries(k);
+    for (int i = 0; i < m; i = successor(i)) destroy(p[i]);
+    free(p);
+}
+
+template<typename S>
+    requires(Semiring(S))
+void matrix_multiply_unblocked(const pointer(typename S::value_type) a,
+                               const pointer(typename S::value_type) b,
+                               pointer(typename S::value_type) c, int k)
+{
+    // Precondition: $c$ is a $k \times k$ zero matrix not overlapping $a$ or $b$
+    // Postcondition: $c = a b$
+    typedef typename S::value_type T;
+    for (int i = 0; i < k; i = successor(i))
+        for (int p = 0; p < k; p = successor(p)) {
+            T x = a[i * k + p];
+            const pointer(T) r = b + p * k;
+            pointer(T) s = c + i * k;
+            for (int j = 0; j < k; j = successor(j))
+                s[j] = S::add(s[j], S::multiply(x, r[j]));
+        }
+}
+
+template<typename S>
+    requires(Semiring(S))
+void matrix_multiply_tile(const pointer(typename S::value_type) a,
+                          const pointer(typename S::value_type) b,
+                          pointer(typename S::value_type) c, int k,
+                          int p0, int p1)
+{
+    // Precondition: $a$, $b$ and $c$ address row $i$ and column $j$ of
+    // $k \times k$ matrices, with rows $[i, i + 4)$ and columns $[j, j + 4)$
+    // Postcondition: adds to that tile of $c$ the terms $a_{ip} b_{pj}$
+    //     for $p_0 \leq p < p_1$
+    // The tile is held in local variables across the whole range of $p$,
+    // so that each entry of $b$ loaded serves four rows
+    typedef typename S::value_type T;
+    T t[4][4];
+    for (int u = 0; u < 4; u = successor(u))
+        for (int v = 0; v < 4; v = successor(v)) t[u][v] = c[u * k + v];
+    for (int p = p0; p < p1; p = successor(p)) {
+        const pointer(T) r = b + p * k;
+        for (int u = 0; u < 4; u = successor(u)) {
+            T x = a[u * k + p];
+            for (int v = 0; v < 4; v = successor(v))
+                t[u][v] = S::add(t[u][v], S::multiply(x, r[v]));
+        }
+    }
+    for (int u = 0; u < 4; u = successor(u))
+        for (int v = 0; v < 4; v = successor(v)) c[u * k + v] = t[u][v];
+}
+
+template<typename S, int n>
+    requires(Semiring(S))
+void matrix_multiply_blocked(const pointer(typename S::value_type) a,
+                             const pointer(typename S::value_type) b,
+                             pointer(typename S::value_type) c, int k)
+{
+    // Precondition: $c$ is a $k \times k$ zero matrix not overlapping $a$ or $b$
+    // Precondition: $n = 0 \vee k = n$
+    // Postcondition: $c = a b$
+    // Blocks of $\func{matrix\_block}^2$ entries of $b$ stay in cache while
+    // the rows of $a$ pass over them in tiles of 4 rows and 4 columns of
+    // $c$; rows and columns left over at the edges go entry by entry
+    typedef typename S::value_type T;
+    if (n != 0) k = n;
+    int k4 = k - k % 4;
+    for (int p0 = 0; p0 < k; p0 = p0 + matrix_block) {
+        int p1 = k - p0 < matrix_block ? k : p0 + matrix_block;
+        for (int j0 = 0; j0 < k4; j0 = j0 + matrix_block) {
+            int j1 = k4 - j0 < matrix_block ? k4 : j0 + matrix_block;
+            for (int i = 0; i < k4; i = i + 4)
+                for (int j = j0; j < j1; j = j + 4)
+                    matrix_multiply_tile<S>(a + i * k, b + j, c + (i * k + j),
+                                            k, p0, p1);
+        }
+        for (int i = 0; i < k; i = successor(i))
+            for (int p = p0; p < p1; p = successor(p)) {
+                T x = a[i * k + p];
+                const pointer(T) r = b + p * k;
+                pointer(T) s = c + i * k;
+                for (int j = i < k4 ? k4 : 0; j < k; j = successor(j))
+                    s[j] = S::add(s[j], S::multiply(x, r[j]));
+            }
+    }
+}
+
+template<typename S, int n = 0>
+    requires(Semiring(S))
+struct matrix
+{
+    typedef typename S::value_type T;
+    pointer(T) a;
+    int k;                     // dimension
+    explicit matrix(int k = n) : a(allocate_matrix<S>(k)), k(k)
+    {
+        // Precondition: $n = 0 \vee k = n$
+        // Postcondition: all entries are $zero$
+    }
+    matrix(const matrix& x) : a(allocate_matrix<S>(0)), k(0)
+    {
+        deref(this) = x;
+    }
+    void operator=(const matrix& x)
+    {
+        if (this == &x) return;
+        if (k != x.k) {
+            deallocate_matrix<S>(a, k);
+            a = allocate_matrix<S>(x.k);
+            k = x.k;
+        }
+        for (int i = 0; i < k * k; i = successor(i)) a[i] = x.a[i];
+    }
+    ~matrix()
+    {
+        deallocate_matrix<S>(a, k);
+    }
+    int dimension() const
+    {
+        return n == 0 ? k : n;
+    }
+    T& operator()(int i, int j)
+    {
+        // Precondition: $0 \leq i, j < \func{dimension}()$
+        return a[i * dimension() + j];
+    }
+    const T& operator()(int i, int j) const
+    {
+        // Precondition: $0 \leq i, j < \func{dimension}()$
+        return a[i * dimension() + j];
+    }
+};
+
+template<typename S, int n>
+    requires(Semiring(S))
+bool operator==(const matrix<S, n>& x, const matrix<S, n>& y)
+{
+    if (x.dimension() != y.dimension()) return false;
+    int k = x.dimension();
+    for (int i = 0; i < k * k; i = successor(i))
+        if (!(x.a[i] == y.a[i])) return false;
+    return true;
+}
+
+template<typename S, int n>
+    requires(Semiring(S))
+matrix<S, n> operator*(const matrix<S, n>& x, const matrix<S, n>& y)
+{
+    // Precondition: $x.\func{dimension}() = y.\func{dimension}()$
+    matrix<S, n> z(x.dimension());
+    matrix_multiply_blocked<S, n>(x.a, y.a, z.a, x.dimension());
+    return z;
+}
+
+template<typename S, int n>
+    requires(Semiring(S))
+matrix<S, n> identity_matrix(int k = n)
+{
+    // Precondition: $n = 0 \vee k = n$
+    matrix<S, n> x(k);
+    for (int i = 0; i < k; i = successor(i)) x(i, i) = S::one();
+    return x;
+}
+
+#endif // EOP_MATRICES
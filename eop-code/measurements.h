@@ -25,6 +25,15 @@
 #include "intrinsics.h"
 #include "type_functions.h"
 #include "eop.h"
+#include "orbits.h"
+#include "powers.h"
+#include "multiprecision.h"
+#include "matrices.h"
+#include "selection.h"
+#include "euclidean.h"
+#include "rationals.h"
+#include "polynomials.h"
+#include "search.h"
 #include "tests.h" // rational
 #include "print.h"
 #include "assertions.h"
@@ -117,6 +126,1132 @@ struct measure_gcd
     }
 };
 
+struct measure_gcd_lazy_rational
+{
+    const pointer(char) legend;
+    typedef lazy_rational<int> Q;
+    Q t;
+    measure_gcd_lazy_rational() :
+        legend("gcd<Q, Q>(Q(250, 1000), Q(750, 1000)), lazy_rational<int>") { }
+    inline void operator()() {
+        t = gcd<Q, Q>(Q(250, 1000), Q(750, 1000));
+    }
+};
+
+template<int k>
+struct measure_rational_sum
+{
+    // Sums of 1000 fractions with denominators up to 8 with $k = 0$:
+    // rational<long long> reduced after every addition, 1: lazy_rational,
+    // reduced at the end; and normalizing $2^{12}$ lazy_rational<int> one at a time
+    // with $k = 2$, or with $\func{normalize\_n}$ with $k = 3$
+    const pointer(char) legend;
+    typedef long long N;
+    array< rational<N> > x;
+    array< lazy_rational<N> > y;
+    array< lazy_rational<int> > z;
+    rational<N> r;
+    lazy_rational<N> s;
+    measure_rational_sum() :
+        legend(k == 0 ? "rational<long long> sum, reduced every step" :
+               k == 1 ? "lazy_rational<long long> sum" :
+               k == 2 ? "normalize(lazy_rational<int>), 2^12" :
+                        "normalize_n(lazy_rational<int>), 2^12"),
+            x(1000, 1000, rational<N>(0)), y(1000, 1000, lazy_rational<N>(0)),
+            z(1 << 12, 1 << 12, lazy_rational<int>(0)) {
+        for (int i = 0; i < 1000; i = successor(i)) {
+            x[i] = rational<N>(N(i % 13 - 6), N(i % 8 + 1));
+            y[i] = lazy_rational<N>(N(i % 13 - 6), N(i % 8 + 1));
+        }
+        unsigned long long t = 1;
+        for (int i = 0; i < (1 << 12); i = successor(i)) {
+            // Unreduced, with magnitudes near $2^{31}$, as lazy_rational leaves them
+            t = t * 6364136223846793005ull + 1442695040888963407ull;
+            int c = int(t >> 60) + 1;
+            z[i] = lazy_rational<int>(int((t >> 5) & 0x7ffffff) * c,
+                                      int((t >> 32) & 0x7ffffff) * c + c);
+        }
+    }
+    inline void operator()() {
+        if (k == 0) {
+            r = rational<N>(0);
+            for (int i = 0; i < 1000; i = successor(i)) r = normalize(r + x[i]);
+        } else if (k == 1) {
+            s = lazy_rational<N>(0);
+            for (int i = 0; i < 1000; i = successor(i)) s = s + y[i];
+            s = normalize(s);
+        } else if (k == 2) {
+            array< lazy_rational<int> > w(z);
+            for (int i = 0; i < (1 << 12); i = successor(i)) w[i] = normalize(w[i]);
+        } else {
+            array< lazy_rational<int> > w(z);
+            normalize_n(begin(w), 1 << 12);
+        }
+    }
+};
+
+template<int k, bool skewed>
+struct measure_gcd_integer
+{
+    // 1000 gcds of operands below $2^{62}$, or of such and 16-bit ones, with
+    // $k = 0$: \func{gcd} by remainder, 1: generic \func{stein\_gcd\_nonnegative},
+    //     2: \func{binary\_gcd}
+    const pointer(char) legend;
+    typedef long long N;
+    array<N> x;
+    array<N> r;
+    measure_gcd_integer() :
+        legend(k == 0 ? (skewed ? "gcd<unsigned long long>, skewed" :
+                                  "gcd<unsigned long long>") :
+               k == 1 ? (skewed ? "stein_gcd_nonnegative<long long>, skewed" :
+                                  "stein_gcd_nonnegative<long long>") :
+                        (skewed ? "gcd<long long> (binary_gcd), skewed" :
+                                  "gcd<long long> (binary_gcd)")),
+            x(1001, 1001, N(0)), r(1000, 1000, N(0)) {
+        unsigned long long s = 1;
+        for (int i = 0; i < 1001; i = successor(i)) {
+            s = s * 6364136223846793005ull + 1442695040888963407ull;
+            x[i] = N(s >> (skewed && odd(i) ? 48 : 8)) | N(1);
+            if (i % 3 == 0) x[i] = x[i] << (i % 7);
+        }
+    }
+    inline void operator()() {
+        typedef unsigned long long U;
+        if (k == 0)
+            for (int i = 0; i < 1000; i = successor(i))
+                r[i] = N(gcd<U>(U(x[i]), U(x[i + 1])));
+        else if (k == 1)
+            for (int i = 0; i < 1000; i = successor(i))
+                r[i] = stein_gcd_nonnegative<N>(x[i], x[i + 1]);
+        else
+            for (int i = 0; i < 1000; i = successor(i))
+                r[i] = gcd<N>(x[i], x[i + 1]);
+    }
+};
+
+template<typename T, int k>
+struct measure_gcd_n
+{
+    // gcds of $2^{16}$ pairs of operands below $2^{30}$ or $2^{62}$ with
+    // $k = 0$: \func{gcd} one pair at a time, 1: \func{gcd\_n},
+    //     2: \func{gcd\_n} on 4 threads, 3: \func{reduce\_gcd\_n} of $x$ where
+    //     all share a factor, and 4: \func{reduce\_gcd\_n} on 4 threads
+    const pointer(char) legend;
+    array<T> x;
+    array<T> y;
+    array<T> z;
+    T r;
+    measure_gcd_n() :
+        legend(sizeof(T) == 4 ?
+                   (k == 0 ? "gcd<int> one at a time, 2^16 pairs" :
+                    k == 1 ? "gcd_n<int>, 2^16 pairs" :
+                    k == 2 ? "gcd_n<int>, 2^16 pairs, 4 threads" :
+                    k == 3 ? "reduce_gcd_n<int>, 2^16 multiples of 12" :
+                             "reduce_gcd_n<int>, 2^16 multiples of 12, 4 threads") :
+                   (k == 0 ? "gcd<long long> one at a time, 2^16 pairs" :
+                    k == 1 ? "gcd_n<long long>, 2^16 pairs" :
+                    k == 2 ? "gcd_n<long long>, 2^16 pairs, 4 threads" :
+                    k == 3 ? "reduce_gcd_n<long long>, 2^16 multiples of 12" :
+                             "reduce_gcd_n<long long>, 2^16 multiples of 12, 4 threads")),
+            x(1 << 16, 1 << 16, T(0)), y(1 << 16, 1 << 16, T(0)),
+            z(1 << 16, 1 << 16, T(0)), r(0) {
+        int b = sizeof(T) == 4 ? 34 : 2;
+        unsigned long long s = 1;
+        for (int i = 0; i < (1 << 16); i = successor(i)) {
+            s = s * 6364136223846793005ull + 1442695040888963407ull;
+            x[i] = T(s >> b);
+            s = s * 6364136223846793005ull + 1442695040888963407ull;
+            y[i] = T(s >> b);
+            if (k > 2) x[i] = (x[i] >> 4) * T(12);
+        }
+    }
+    inline void operator()() {
+        typedef DistanceType(pointer(T)) N;
+        N n(1 << 16);
+        if (k == 0)
+            for (N i = 0; i < n; i = successor(i)) z[i] = gcd<T>(x[i], y[i]);
+        else if (k < 3)
+            gcd_n(begin(x), n, begin(y), begin(z), k == 1 ? 1 : 4);
+        else
+            r = reduce_gcd_n(begin(x), n, k == 3 ? 1 : 4);
+    }
+};
+
+struct measure_power_unary_stepwise
+{
+    const pointer(char) legend;
+    LCG f;
+    LCG::T x;
+    measure_power_unary_stepwise() :
+        legend("power_unary(x0, 10^6, Lehmer 1949) one step at a time"),
+            f(lehmer_1949()) { }
+    inline void operator()() {
+        x = power_unary(f.x0, 1000000ull, f, transformation_tag());
+    }
+};
+
+struct measure_power_unary_composable
+{
+    const pointer(char) legend;
+    LCG f;
+    LCG::T x;
+    measure_power_unary_composable() :
+        legend("power_unary(x0, 2^40, Lehmer 1949) by composition"),
+            f(lehmer_1949()) { }
+    inline void operator()() {
+        x = power_unary(f.x0, 1ull << 40, f);
+    }
+};
+
+template<int lo, int hi>
+struct addition_chain_lengths
+{
+    // Writes $\func{addition\_chain}<n>::length$ for $n \in [lo, hi)$ to $f$
+    static void copy(pointer(int) f)
+    {
+        addition_chain_lengths<lo, (lo + hi) / 2>::copy(f);
+        addition_chain_lengths<(lo + hi) / 2, hi>::copy(f + ((hi - lo) / 2));
+    }
+};
+
+template<int n>
+struct addition_chain_lengths<n, n + 1>
+{
+    static void copy(pointer(int) f)
+    {
+        sink(f) = addition_chain<n>::length;
+    }
+};
+
+void measure_power_chain_operations()
+{
+    typedef multiplies<unsigned> Op;
+    const int n = 1024;
+    array<int> l(n + 1, n + 1, 0);
+    addition_chain_lengths<2, n + 1>::copy(begin(l) + 2);
+    int total_chain(0);
+    int total_binary(0);
+    int shorter(0);
+    for (int i = 2; i <= n; i = successor(i)) {
+        int c = 0;
+        power(3u, i, instrumented_operation<Op, pointer(int)>(Op(), &c));
+        total_chain = total_chain + l[i];
+        total_binary = total_binary + c;
+        if (l[i] < c) shorter = successor(shorter);
+        if (i == 15 || i == 255 || i == 1023 || i == 1024) {
+            print("power<"); print(i); print(">: "); print(l[i]);
+                print(" operations, power: "); print(c); print_eol();
+        }
+    }
+    print("Exponents 2-1024: power<n> "); print(total_chain);
+        print(" operations, power "); print(total_binary);
+            print("; ratio = "); print(double(total_binary) / double(total_chain));
+                print("; shorter for "); print(shorter); print(" exponents");
+                    print_eol();
+}
+
+template<int n, bool chain>
+struct measure_power_constant
+{
+    // Raises 1000 values to the constant power $n$
+    const pointer(char) legend;
+    array<unsigned> x;
+    unsigned r;
+    measure_power_constant() :
+        legend(chain ?
+            (n == 15 ? "power<15>(x, multiplies) on 1000 values" :
+             n == 255 ? "power<255>(x, multiplies) on 1000 values" :
+                        "power<1023>(x, multiplies) on 1000 values") :
+            (n == 15 ? "power(x, 15, multiplies) on 1000 values" :
+             n == 255 ? "power(x, 255, multiplies) on 1000 values" :
+                        "power(x, 1023, multiplies) on 1000 values")),
+            x(1000, 1000, 0u), r(0u)
+    {
+        iota(1000u, begin(x));
+    }
+    inline void operator()() {
+        typedef multiplies<unsigned> Op;
+        for (int i = 0; i < 1000; i = successor(i))
+            r = r + (chain ? power<n>(x[i], Op()) : power(x[i], n, Op()));
+    }
+};
+
+template<typename I>
+    requires(Integer(I))
+void measure_power_windowed_operations(const pointer(char) name, I n)
+{
+    typedef multiplies<unsigned> Op;
+    typedef instrumented_operation<Op, pointer(int)> Op_counted;
+    int c0(0);
+    int c1(0);
+    int c2(0);
+    power(3u, n, Op_counted(Op(), &c0));
+    power_k_ary(3u, n, Op_counted(Op(), &c1));
+    power_sliding_window(3u, n, Op_counted(Op(), &c2));
+    print(name); print(": power "); print(c0);
+        print(", power_k_ary "); print(c1);
+            print(", power_sliding_window "); print(c2);
+                print(" operations; ratio = "); print(double(c0) / double(c2));
+                    print_eol();
+}
+
+void measure_power_windowed_operations()
+{
+    measure_power_windowed_operations("n = 1000003", 1000003ull);
+    measure_power_windowed_operations("n = 2^32-1", 0xffffffffull);
+    measure_power_windowed_operations("n = 2^61-3", (1ull << 61) - 3ull);
+    measure_power_windowed_operations("n = 2^63+1", 0x8000000000000001ull);
+    measure_power_windowed_operations("n = 0xdeadbeefcafebabe", 0xdeadbeefcafebabeull);
+    measure_power_windowed_operations("n = 2^64-1", 0xffffffffffffffffull);
+}
+
+template<int k>
+struct measure_power_windowed
+{
+    // $a^{p-2} \bmod p$ for $p = 2^{61}-1$ with a costly multiplication,
+    // whose cost grows with the bits of its second argument, so $a$ is
+    // large: $k = 0$ binary, 1 $k$-ary, 2 sliding window
+    typedef unsigned long long I;
+    const pointer(char) legend;
+    I a;
+    I p;
+    I r;
+    measure_power_windowed() :
+        legend(k == 0 ? "power(a, 2^61-3, multiplies_modulo_no_overflow(2^61-1))" :
+               k == 1 ? "power_k_ary(a, 2^61-3, multiplies_modulo_no_overflow(2^61-1))" :
+                        "power_sliding_window(a, 2^61-3, multiplies_modulo_no_overflow(2^61-1))"),
+            a(0x123456789abcdefull), p((1ull << 61) - 1ull), r(0ull) { }
+    inline void operator()() {
+        multiplies_modulo_no_overflow<I> op(p);
+        if (k == 0)      r = power(a, p - I(2), op);
+        else if (k == 1) r = power_k_ary(a, p - I(2), op);
+        else             r = power_sliding_window(a, p - I(2), op);
+    }
+};
+
+template<int n>
+struct measure_fibonacci_big_integer
+{
+    const pointer(char) legend;
+    big_integer f;
+    measure_fibonacci_big_integer() :
+        legend(n == 100000 ? "fibonacci(big_integer(10^5))" :
+               n == 1000000 ? "fibonacci(big_integer(10^6))" :
+                              "fibonacci(big_integer(10^7))") { }
+    inline void operator()() {
+        f = fibonacci(big_integer(n));
+    }
+};
+
+struct measure_power_big_integer
+{
+    const pointer(char) legend;
+    big_integer a;
+    big_integer r;
+    measure_power_big_integer() :
+        legend("power(big_integer(10^40+3), 10^4, multiplies)"),
+            a(successor(successor(successor(
+                power(big_integer(10), 40, multiplies<big_integer>()))))) { }
+    inline void operator()() {
+        r = power(a, 10000, multiplies<big_integer>());
+    }
+};
+
+template<int k, bool lehmer>
+struct measure_extended_gcd
+{
+    // Extended gcd of two $k$-limb numbers, by Euclid's algorithm with a
+    // full-precision division per quotient, or by Lehmer's algorithm
+    const pointer(char) legend;
+    big_integer a;
+    big_integer b;
+    triple<big_integer, big_integer, big_integer> r;
+    measure_extended_gcd() :
+        legend(k == 16 ? (lehmer ? "extended_gcd (Lehmer), 16 limbs" :
+                                   "extended_gcd (Euclid), 16 limbs") :
+               k == 64 ? (lehmer ? "extended_gcd (Lehmer), 64 limbs" :
+                                   "extended_gcd (Euclid), 64 limbs") :
+                         (lehmer ? "extended_gcd (Lehmer), 256 limbs" :
+                                   "extended_gcd (Euclid), 256 limbs")) {
+        unsigned long long s = 1;
+        for (int i = 0; i < k; i = successor(i)) {
+            s = s * 6364136223846793005ull + 1442695040888963407ull;
+            a = binary_scale_up_nonnegative(a, limb_bits) + big_integer(s);
+            s = s * 6364136223846793005ull + 1442695040888963407ull;
+            b = binary_scale_up_nonnegative(b, limb_bits) + big_integer(s);
+        }
+    }
+    inline void operator()() {
+        typedef big_integer I;
+        if (lehmer) {
+            r = extended_gcd(a, b);
+            return;
+        }
+        I x0(1), x1(0), y0(0), y1(1), u(a), v(b);
+        while (!zero(v)) {
+            pair<I, I> qr = quotient_remainder(u, v);
+            u = v; v = qr.m1;
+            I t = x0 - qr.m0 * x1; x0 = x1; x1 = t;
+            t = y0 - qr.m0 * y1;   y0 = y1; y1 = t;
+        }
+        r = triple<I, I, I>(u, x0, y0);
+    }
+};
+
+template<typename T, bool invariant>
+struct measure_quotient_remainder_invariant
+{
+    // 1000 quotient_remainder calls with one divisor, known only at run time,
+    // by the hardware division or by $\func{quotient\_remainder\_invariant}$;
+    // each dividend depends on the previous remainder, as in an orbit
+    const pointer(char) legend;
+    array<T> a;
+    T d;
+    T r;
+    measure_quotient_remainder_invariant() :
+        legend(sizeof(T) == sizeof(int) ?
+                   (invariant ? "quotient_remainder, invariant divisor, int" :
+                                "quotient_remainder, quo_rem, int") :
+                   (invariant ? "quotient_remainder, invariant divisor, long long" :
+                                "quotient_remainder, quo_rem, long long")),
+            a(1000, 1000, T(0)) {
+        unsigned long long s = 1;
+        for (int i = 0; i < 1000; i = successor(i)) {
+            s = s * 6364136223846793005ull + 1442695040888963407ull;
+            a[i] = T(s >> 2) & T(~(DistanceType(T)(3) << (sizeof(T) * 8 - 2)));
+        }
+        d = T(a[0] % T(100000)) + T(7);
+    }
+    inline void operator()() {
+        T x(0);
+        r = T(0);
+        if (invariant) {
+            quotient_remainder_invariant<T> f(d);
+            for (int i = 0; i < 1000; i = successor(i)) {
+                pair<T, T> p = quotient_remainder(a[i] + x, d, f);
+                x = p.m1;
+                r = r + p.m0;
+            }
+        } else {
+            for (int i = 0; i < 1000; i = successor(i)) {
+                pair<T, T> p = quotient_remainder(a[i] + x, d, quo_rem<T>());
+                x = p.m1;
+                r = r + p.m0;
+            }
+        }
+    }
+};
+
+template<int k>
+struct measure_polynomial_product
+{
+    // Products of polynomials: with $k = 0$, degree 1000 over long long by
+    // schoolbook convolution; 1, the same by Karatsuba; 2, degree $10^6$
+    // over modular_integer<998244353> by the number-theoretic transform;
+    // and with $k = 3$, the remainder of degree 2000 by degree 1000 over
+    // modular_integer<998244353>
+    const pointer(char) legend;
+    typedef modular_integer<998244353u> Z;
+    polynomial<long long> f, g, h;
+    polynomial<Z> f_z, g_z, h_z;
+    measure_polynomial_product() :
+        legend(k == 0 ? "polynomial product, degree 1000, schoolbook" :
+               k == 1 ? "polynomial product, degree 1000, Karatsuba" :
+               k == 2 ? "polynomial product, degree 10^6, NTT" :
+                        "polynomial remainder, degree 2000 by 1000") {
+        unsigned long long s = 1;
+        int n = k == 2 ? 1000000 : 1000;
+        if (k < 2) {
+            f = random_polynomial<long long>(n, s);
+            g = random_polynomial<long long>(n, s);
+            h = f * g;
+        } else {
+            f_z = random_polynomial<Z>(k == 3 ? twice(n) : n, s);
+            g_z = random_polynomial<Z>(n, s);
+        }
+    }
+    inline void operator()() {
+        if (k == 0)
+            convolution_schoolbook(begin(f.coeff), int(size(f.coeff)),
+                                   begin(g.coeff), int(size(g.coeff)),
+                                   begin(h.coeff));
+        else if (k == 1) h = f * g;
+        else if (k == 2) h_z = f_z * g_z;
+        else h_z = remainder(f_z, g_z);
+    }
+};
+
+template<bool newton>
+struct measure_polynomial_division
+{
+    // Quotient and remainder of degree 20000 by degree 10000 over
+    // modular_integer<998244353>, by long division or by Newton's iteration
+    const pointer(char) legend;
+    typedef polynomial< modular_integer<998244353u> > P;
+    P f, g;
+    pair<P, P> r;
+    measure_polynomial_division() :
+        legend(newton ? "polynomial quotient_remainder, degree 20000 by 10000, Newton" :
+                        "polynomial quotient_remainder, degree 20000 by 10000, long division") {
+        unsigned long long s = 1;
+        f = random_polynomial<modular_integer<998244353u> >(20000, s);
+        g = random_polynomial<modular_integer<998244353u> >(10000, s);
+    }
+    inline void operator()() {
+        if (newton) r = quotient_remainder_newton(f, g);
+        else        r = quotient_remainder_schoolbook(f, g);
+    }
+};
+
+template<typename T, bool batch>
+struct measure_polynomial_evaluate
+{
+    // A polynomial of degree 1000 at 1000 points, one point at a time with
+    // evaluate or all together with evaluate_n
+    const pointer(char) legend;
+    polynomial<T> f;
+    array<T> x;
+    array<T> y;
+    measure_polynomial_evaluate() :
+        legend(sizeof(T) == sizeof(double) ?
+                   (batch ? "evaluate_n, degree 1000, 1000 points, double" :
+                            "evaluate, degree 1000, 1000 points, double") :
+                   (batch ? "evaluate_n, degree 1000, 1000 points, modular_integer" :
+                            "evaluate, degree 1000, 1000 points, modular_integer")),
+            x(1000, 1000, T(0)), y(1000, 1000, T(0)) {
+        unsigned long long s = 1;
+        f = random_polynomial<T>(1000, s);
+        for (int i = 0; i < 1000; i = successor(i)) x[i] = T(i % 3 - 1);
+    }
+    inline void operator()() {
+        if (batch) evaluate_n(f, begin(x), 1000, begin(y));
+        else
+            for (int i = 0; i < 1000; i = successor(i)) y[i] = evaluate(f, x[i]);
+    }
+};
+
+template<int k>
+struct measure_sparse_polynomial
+{
+    // Polynomials of degree $10^6$ with 300 terms over
+    // modular_integer<998244353>: with $k = 0$, product of dense
+    // polynomials (by the number-theoretic transform); 1, product of
+    // sparse ones; 2, sum of dense ones; 3, sum of sparse ones
+    const pointer(char) legend;
+    typedef modular_integer<998244353u> Z;
+    polynomial<Z> f, g, h;
+    sparse_polynomial<Z> f_s, g_s, h_s;
+    measure_sparse_polynomial() :
+        legend(k == 0 ? "polynomial product, degree 10^6, 300 terms" :
+               k == 1 ? "sparse_polynomial product, degree 10^6, 300 terms" :
+               k == 2 ? "polynomial sum, degree 10^6, 300 terms" :
+                        "sparse_polynomial sum, degree 10^6, 300 terms") {
+        unsigned long long s = 1;
+        f = random_sparse_polynomial<Z>(1000000, 300, s);
+        g = random_sparse_polynomial<Z>(1000000, 300, s);
+        f_s = sparse_polynomial<Z>(f);
+        g_s = sparse_polynomial<Z>(g);
+    }
+    inline void operator()() {
+        if (k == 0)      h = f * g;
+        else if (k == 1) h_s = f_s * g_s;
+        else if (k == 2) h = f + g;
+        else             h_s = f_s + g_s;
+    }
+};
+
+template<int k>
+struct measure_search
+{
+    // $10^5$ lower_bound searches in $2^{23}$ sorted int: with $k = 0$, by
+    // lower_bound_n; 1, in a btree_index one at a time; 2, in a
+    // btree_index all together with lower_bounds_n
+    const pointer(char) legend;
+    typedef pointer(int) I;
+    array<int> a;
+    array<int> q;
+    array<I> o;
+    btree_index<I> e;
+    long long r;
+    measure_search() :
+        legend(k == 0 ? "lower_bound_n, 2^23 int, 10^5 searches" :
+               k == 1 ? "lower_bound, btree_index, 2^23 int, 10^5 searches" :
+                        "lower_bounds_n, btree_index, 2^23 int, 10^5 searches"),
+            a(1 << 23, 1 << 23, 0), q(100000, 100000, 0),
+            o(100000, 100000, I(0)) {
+        for (int i = 0; i < (1 << 23); i = successor(i)) a[i] = 2 * i;
+        unsigned long long s = 1;
+        for (int i = 0; i < 100000; i = successor(i)) {
+            s = s * 6364136223846793005ull + 1442695040888963407ull;
+            q[i] = int((s >> 33) % (1 << 24));
+        }
+        e.f = begin(a);
+        e.n = size(a);
+        if (k != 0) btree_build(e);
+    }
+    inline void operator()() {
+        I f = begin(a);
+        r = 0;
+        if (k == 2) {
+            lower_bounds_n(e, begin(q), 100000, begin(o), less<int>());
+            for (int i = 0; i < 100000; i = successor(i)) r = r + (o[i] - f);
+        } else {
+            for (int i = 0; i < 100000; i = successor(i))
+                if (k == 1) r = r + (lower_bound(e, q[i], less<int>()) - f);
+                else        r = r + (lower_bound_n(f, size(a), q[i], less<int>()) - f);
+        }
+    }
+};
+
+template<int threads>
+struct measure_reduce_balanced
+{
+    // Balanced sum of $2^{22}$ doubles on the given number of threads
+    const pointer(char) legend;
+    array<double> a;
+    double r;
+    measure_reduce_balanced() :
+        legend(threads == 1 ? "reduce_balanced_n, 2^22 double, 1 thread" :
+               threads == 2 ? "reduce_balanced_n, 2^22 double, 2 threads" :
+                              "reduce_balanced_n, 2^22 double, 4 threads"),
+            a(1 << 22, 1 << 22, 0.0) {
+        for (int i = 0; i < (1 << 22); i = successor(i))
+            a[i] = double(i % 1000) / 7.0;
+    }
+    inline void operator()() {
+        r = reduce_balanced_n(begin(a), 1 << 22, plus<double>(), 0.0, threads);
+    }
+};
+
+template<typename T, bool lanes>
+struct measure_quantifiers
+{
+    // find and count of a value over 10000 elements of $T$, with the
+    // generic loop or a block of quantifier_lanes elements at a time
+    const pointer(char) legend;
+    array<T> a;
+    pointer(T) r;
+    DistanceType(pointer(T)) n;
+    measure_quantifiers() :
+        legend(sizeof(T) == sizeof(char) ?
+                   (lanes ? "find and count, 10000 char, lanes" :
+                            "find and count, 10000 char, generic") :
+               sizeof(T) == sizeof(int) ?
+                   (lanes ? "find and count, 10000 int, lanes" :
+                            "find and count, 10000 int, generic") :
+                   (lanes ? "find and count, 10000 double, lanes" :
+                            "find and count, 10000 double, generic")),
+            a(10000, 10000, T(0)) {
+        for (int i = 0; i < 10000; i = successor(i)) a[i] = T(i % 7 + 2);
+    }
+    inline void operator()() {
+        typedef DistanceType(pointer(T)) N;
+        pointer(T) f = begin(a);
+        pointer(T) l = end(a);
+        if (lanes) {
+            r = find(f, l, T(1));
+            n = count(f, l, T(2));
+        } else {
+            r = find(f, l, T(1), storage_tag());
+            n = count(f, l, T(2), N(0), storage_tag());
+        }
+    }
+};
+
+template<bool karatsuba>
+struct measure_limbs_multiply
+{
+    // Products of 2000-limb numbers
+    const pointer(char) legend;
+    big_integer a;
+    big_integer b;
+    array<limb> r;
+    measure_limbs_multiply() :
+        legend(karatsuba ? "limbs_multiply, 2000 limbs" :
+                           "limbs_multiply_schoolbook, 2000 limbs"),
+            a(predecessor(binary_scale_up_nonnegative(big_integer(1), 128000))),
+            b(a), r(4000, 4000, limb(0)) { }
+    inline void operator()() {
+        if (karatsuba) limbs_multiply(a.d, a.n, b.d, b.n, begin(r));
+        else           limbs_multiply_schoolbook(a.d, a.n, b.d, b.n, begin(r));
+    }
+};
+
+template<int k, bool large>
+struct measure_multiplies_modulo
+{
+    // 1000 independent products modulo $2^{32}-5$ or $2^{61}-1$ with
+    // $k = 0$: %, 1: 128-bit %, 2: Barrett, 3: Montgomery
+    const pointer(char) legend;
+    limb m;
+    array<limb> x;
+    array<limb> r;
+    measure_multiplies_modulo() :
+        legend(k == 0 ? "multiplies_modulo, 2^32-5" :
+               k == 1 ? (large ? "multiplies_modulo_wide, 2^61-1" :
+                                 "multiplies_modulo_wide, 2^32-5") :
+               k == 2 ? (large ? "multiplies_modulo_barrett, 2^61-1" :
+                                 "multiplies_modulo_barrett, 2^32-5") :
+                        (large ? "multiplies_modulo_montgomery, 2^61-1" :
+                                 "multiplies_modulo_montgomery, 2^32-5")),
+            m(large ? (1ull << 61) - 1ull : 4294967291ull),
+            x(1001, 1001, limb(0)), r(1000, 1000, limb(0)) {
+        for (int i = 0; i < 1001; i = successor(i))
+            x[i] = (limb(i) * 0x9e3779b97f4a7c15ull) % m;
+    }
+    inline void operator()() {
+        if (k == 0) {
+            multiplies_modulo<limb> op(m);
+            for (int i = 0; i < 1000; i = successor(i)) r[i] = op(x[i], x[i + 1]);
+        } else if (k == 1) {
+            multiplies_modulo_wide op(m);
+            for (int i = 0; i < 1000; i = successor(i)) r[i] = op(x[i], x[i + 1]);
+        } else if (k == 2) {
+            multiplies_modulo_barrett op(m);
+            for (int i = 0; i < 1000; i = successor(i)) r[i] = op(x[i], x[i + 1]);
+        } else {
+            // Operands stay in Montgomery form across a computation
+            multiplies_modulo_montgomery op(m);
+            for (int i = 0; i < 1000; i = successor(i)) r[i] = op(x[i], x[i + 1]);
+        }
+    }
+};
+
+template<int k, int n>
+struct select_k_n_procedure
+{
+    template<typename R>
+    void operator()(pointer(int) f, R r) { select_k_n<k, n>(f, r); }
+};
+
+struct select_1_3_procedure
+{
+    template<typename R>
+    void operator()(pointer(int) f, R r) { select_1_3(f[0], f[1], f[2], r); }
+};
+
+struct select_1_4_procedure
+{
+    template<typename R>
+    void operator()(pointer(int) f, R r)
+    {
+        select_1_4<0,1,2,3>(f[0], f[1], f[2], f[3], r);
+    }
+};
+
+struct select_2_5_procedure
+{
+    template<typename R>
+    void operator()(pointer(int) f, R r)
+    {
+        select_2_5<0,1,2,3,4>(f[0], f[1], f[2], f[3], f[4], r);
+    }
+};
+
+template<typename S>
+void measure_select_comparisons(const pointer(char) legend, int n, S s)
+{
+    // Worst and average comparisons over all permutations of $n$ keys
+    typedef instrumented_less< less<int>, pointer(int) > R;
+    int a[16];
+    iota(n, a);
+    int worst(0);
+    double total(0);
+    double permutations(0);
+    do {
+        int c(0);
+        s(a, R(less<int>(), &c));
+        if (c > worst) worst = c;
+        total = total + c;
+        permutations = permutations + 1;
+    } while (next_permutation(a, a + n, less<int>()));
+    print(legend); print(": worst "); print(worst);
+        print(", average "); print(total / permutations); print_eol();
+}
+
+void measure_select_comparisons()
+{
+    measure_select_comparisons("select_1_3", 3, select_1_3_procedure());
+    measure_select_comparisons("select_k_n<1, 3>", 3, select_k_n_procedure<1, 3>());
+    measure_select_comparisons("select_1_4", 4, select_1_4_procedure());
+    measure_select_comparisons("select_k_n<1, 4>", 4, select_k_n_procedure<1, 4>());
+    measure_select_comparisons("select_2_5", 5, select_2_5_procedure());
+    measure_select_comparisons("select_k_n<2, 5>", 5, select_k_n_procedure<2, 5>());
+    measure_select_comparisons("select_k_n<2, 7>", 7, select_k_n_procedure<2, 7>());
+    measure_select_comparisons("select_k_n<3, 7>", 7, select_k_n_procedure<3, 7>());
+    measure_select_comparisons("select_k_n<4, 9>", 9, select_k_n_procedure<4, 9>());
+}
+
+template<bool generated>
+struct measure_select_2_5
+{
+    // Medians of $10^5$ windows of 5 random ints
+    const pointer(char) legend;
+    array<int> x;
+    int m;
+    measure_select_2_5() :
+        legend(generated ? "select_k_n<2, 5>, 10^5 windows" :
+                           "select_2_5, 10^5 windows"),
+            x(500000, 500000, 0), m(0) {
+        unsigned u = 1u;
+        for (int i = 0; i < 500000; i = successor(i)) {
+            u = u * 1103515245u + 12345u;
+            x[i] = int(u >> 8);
+        }
+    }
+    inline void operator()() {
+        pointer(int) f = begin(x);
+        for (int i = 0; i < 500000; i = i + 5)
+            if (generated) m = m + source(select_k_n<2, 5>(f + i, less<int>()));
+            else           m = m + select_2_5<0,1,2,3,4>(f[i], f[i + 1], f[i + 2],
+                                                         f[i + 3], f[i + 4], less<int>());
+    }
+};
+
+template<bool network>
+struct measure_median_5_filter
+{
+    // Medians of the $10^6 - 4$ windows of 5 random samples
+    const pointer(char) legend;
+    array<int> x;
+    array<int> y;
+    measure_median_5_filter() :
+        legend(network ? "median_5_filter_n, 10^6 samples" :
+                         "median_5 per window, 10^6 samples"),
+            x(1000000, 1000000, 0), y(1000000, 1000000, 0) {
+        unsigned u = 1u;
+        for (int i = 0; i < 1000000; i = successor(i)) {
+            u = u * 1103515245u + 12345u;
+            x[i] = int(u >> 8);
+        }
+    }
+    inline void operator()() {
+        pointer(int) f = begin(x);
+        if (network) {
+            median_5_filter_n(f, 1000000, begin(y), less<int>());
+        } else {
+            pointer(int) o = begin(y);
+            for (int i = 0; i < 1000000 - 4; i = successor(i))
+                o[i] = median_5(f[i], f[i + 1], f[i + 2], f[i + 3], f[i + 4],
+                                less<int>());
+        }
+    }
+};
+
+template<bool blocked>
+struct measure_matrix_multiply
+{
+    // Products of $512 \times 512$ matrices of doubles
+    typedef arithmetic_semiring<double> S;
+    const pointer(char) legend;
+    matrix<S, 0> a;
+    matrix<S, 0> c;
+    measure_matrix_multiply() :
+        legend(blocked ? "matrix_multiply_blocked, 512 x 512" :
+                         "matrix_multiply_unblocked, 512 x 512"),
+            a(512), c(512) {
+        for (int i = 0; i < 512; i = successor(i))
+            for (int j = 0; j < 512; j = successor(j)) a(i, j) = double(i ^ j);
+    }
+    inline void operator()() {
+        for (int i = 0; i < 512 * 512; i = successor(i)) c.a[i] = 0.0;
+        if (blocked) matrix_multiply_blocked<S, 0>(a.a, a.a, c.a, 512);
+        else         matrix_multiply_unblocked<S>(a.a, a.a, c.a, 512);
+    }
+};
+
+template<int n>
+struct measure_matrix_power
+{
+    // Shortest paths of a $128 \times 128$ integer weight matrix with the
+    // dimension fixed at compile time ($n = 128$) or at run time ($n = 0$)
+    typedef tropical_semiring<int> S;
+    typedef matrix<S, n> M;
+    const pointer(char) legend;
+    M w;
+    M r;
+    measure_matrix_power() :
+        legend(n == 0 ? "power, tropical matrix<0>, 128 x 128" :
+                        "power, tropical matrix<128>, 128 x 128"),
+            w(128), r(128) {
+        for (int i = 0; i < 128; i = successor(i))
+            for (int j = 0; j < 128; j = successor(j))
+                w(i, j) = (i * 37 + j * 101) % 1000;
+    }
+    inline void operator()() {
+        r = power(w, 127, multiplies<M>());
+    }
+};
+
+template<int k>
+struct measure_power_modulo
+{
+    // $a^{p-2} \bmod p$ for $p = 2^{61}-1$ with
+    // $k = 1$: 128-bit %, 2: Barrett, 3: Montgomery
+    const pointer(char) legend;
+    limb m;
+    limb r;
+    measure_power_modulo() :
+        legend(k == 1 ? "power, multiplies_modulo_wide, 2^61-1" :
+               k == 2 ? "power, multiplies_modulo_barrett, 2^61-1" :
+                        "power_montgomery, 2^61-1"),
+            m((1ull << 61) - 1ull), r(0) { }
+    inline void operator()() {
+        limb a = 0x123456789abcdefull;
+        if (k == 1)      r = power(a, m - 2ull, multiplies_modulo_wide(m));
+        else if (k == 2) r = power(a, m - 2ull, multiplies_modulo_barrett(m));
+        else             r = power_montgomery(a, m - 2ull, m);
+    }
+};
+
+struct measure_orbit_structure
+{
+    const pointer(char) legend;
+    LCG f;
+    triple<DistanceType(LCG), DistanceType(LCG), LCG::T> t;
+    measure_orbit_structure() :
+        legend("orbit_structure(x0, Lehmer 1949)"), f(lehmer_1949()) { }
+    inline void operator()() {
+        t = orbit_structure(f.x0, f, always_defined<LCG::T>);
+    }
+};
+
+template<int k>
+struct measure_orbit_structure_checkpointed
+{
+    // Saves the state every $2^k$ iterations
+    const pointer(char) legend;
+    LCG f;
+    triple<DistanceType(LCG), DistanceType(LCG), LCG::T> t;
+    measure_orbit_structure_checkpointed() :
+        legend(k == 10 ? "orbit_structure_checkpointed(x0, Lehmer 1949), every 2^10" :
+               k == 16 ? "orbit_structure_checkpointed(x0, Lehmer 1949), every 2^16" :
+                         "orbit_structure_checkpointed(x0, Lehmer 1949), every 2^22"),
+            f(lehmer_1949()) { }
+    inline void operator()() {
+        t = orbit_structure_checkpointed(f.x0, f, always_defined<LCG::T>,
+                                         "eop_measure_checkpoint", 1ull << k);
+        remove_orbit_checkpoints("eop_measure_checkpoint");
+    }
+};
+
+struct measure_orbit_structure_teleporting
+{
+    const pointer(char) legend;
+    LCG f;
+    triple<DistanceType(LCG), DistanceType(LCG), LCG::T> t;
+    measure_orbit_structure_teleporting() :
+        legend("orbit_structure_teleporting(x0, Lehmer 1949)"), f(lehmer_1949()) { }
+    inline void operator()() {
+        t = orbit_structure_teleporting(f.x0, f, always_defined<LCG::T>);
+    }
+};
+
+struct measure_orbit_structure_distinguished
+{
+    const pointer(char) legend;
+    LCG f;
+    triple<DistanceType(LCG), DistanceType(LCG), LCG::T> t;
+    measure_orbit_structure_distinguished() :
+        legend("orbit_structure_distinguished(x0, Lehmer 1949, 10)"), f(lehmer_1949()) { }
+    inline void operator()() {
+        t = orbit_structure_distinguished(f.x0, f, always_defined<LCG::T>, 10);
+    }
+};
+
+template<int threads>
+struct measure_orbit_structure_parallel
+{
+    const pointer(char) legend;
+    LCG f;
+    triple<DistanceType(LCG), DistanceType(LCG), LCG::T> t;
+    measure_orbit_structure_parallel() :
+        legend(threads == 1 ? "orbit_structure_parallel(x0, Lehmer 1949, 10), 1 thread" :
+                              "orbit_structure_parallel(x0, Lehmer 1949, 10), 4 threads"),
+            f(lehmer_1949()) { }
+    inline void operator()() {
+        t = orbit_structure_parallel(f.x0, f, 10, threads);
+    }
+};
+
+struct measure_orbit_structures_lcg
+{
+    const pointer(char) legend;
+    LCG f;
+    array<LCG::T> x;
+    array< triple<DistanceType(LCG), DistanceType(LCG), LCG::T> > t;
+    measure_orbit_structures_lcg() :
+        legend("orbit_structure(x, LCG(10007, 3, 1)) for all x"),
+            f(10007ll, 3ll, 1ll, 0ll, ""), x(f.m, f.m, 0ll),
+            t(f.m, f.m, triple<DistanceType(LCG), DistanceType(LCG), LCG::T>(0ull, 0ull, 0ll))
+    {
+        iota(f.m, begin(x));
+    }
+    inline void operator()() {
+        for (LCG::T i = 0; i < f.m; ++i)
+            t[i] = orbit_structure(x[i], f, always_defined<LCG::T>);
+    }
+};
+
+template<int threads>
+struct measure_orbit_structure_distinguished_n
+{
+    const pointer(char) legend;
+    LCG f;
+    array<LCG::T> x;
+    array< triple<DistanceType(LCG), DistanceType(LCG), LCG::T> > t;
+    measure_orbit_structure_distinguished_n() :
+        legend(threads == 1 ?
+            "orbit_structure_distinguished_n(x, LCG(10007, 3, 1), 4) for all x, 1 thread" :
+            "orbit_structure_distinguished_n(x, LCG(10007, 3, 1), 4) for all x, 4 threads"),
+            f(10007ll, 3ll, 1ll, 0ll, ""), x(f.m, f.m, 0ll),
+            t(f.m, f.m, triple<DistanceType(LCG), DistanceType(LCG), LCG::T>(0ull, 0ull, 0ll))
+    {
+        iota(f.m, begin(x));
+    }
+    inline void operator()() {
+        orbit_structure_distinguished_n(begin(x), f.m, begin(t),
+                                        f, always_defined<LCG::T>, 4, threads);
+    }
+};
+
+template<int k, typename T>
+    requires(Integer(T))
+struct measure_orbit_structure_lanes
+{
+    typedef DistanceType(T) N;
+    const pointer(char) legend;
+    affine_transformation<T> f;
+    array<T> x;
+    array< triple<N, N, T> > t;
+    measure_orbit_structure_lanes() :
+        legend(sizeof(T) == sizeof(int) ?
+            (k == 1 ? "orbit_structure_lanes<1>(all x, (3x+1) mod 2003), int" :
+                      "orbit_structure_lanes<8>(all x, (3x+1) mod 2003), int") :
+            (k == 1 ? "orbit_structure_lanes<1>(all x, (3x+1) mod 2003), long long" :
+                      "orbit_structure_lanes<8>(all x, (3x+1) mod 2003), long long")),
+            f(T(3), T(1), T(2003)), x(2003, 2003, T(0)),
+            t(2003, 2003, triple<N, N, T>(N(0), N(0), T(0)))
+    {
+        iota(T(2003), begin(x));
+    }
+    inline void operator()() {
+        orbit_structure_lanes<k>(begin(x), size(x), begin(t), f);
+    }
+};
+
+struct measure_orbit_structure_each_affine
+{
+    typedef DistanceType(int) N;
+    const pointer(char) legend;
+    affine_transformation<int> f;
+    array< triple<N, N, int> > t;
+    measure_orbit_structure_each_affine() :
+        legend("orbit_structure_nonterminating_orbit(x, (3x+1) mod 2003) for all x"),
+            f(3, 1, 2003), t(2003, 2003, triple<N, N, int>(N(0), N(0), 0)) { }
+    inline void operator()() {
+        for (int x = 0; x < 2003; ++x)
+            t[x] = orbit_structure_nonterminating_orbit(x, f);
+    }
+};
+
+template<typename N>
+    requires(Integer(N))
+void random_table(array<N>& f, N n)
+{
+    // $f$ is a random mapping of $[0, n)$ into itself
+    LCG g = lehmer_1949();
+    LCG::T x = g.x0;
+    f = array<N>(n, n, N(0));
+    for (N i(0); i < n; i = successor(i)) {
+        x = g(x);
+        f[i] = N(x % LCG::T(n));
+    }
+}
+
+struct measure_orbit_structure_each_table
+{
+    typedef DistanceType(pointer(int)) N;
+    const pointer(char) legend;
+    N n;
+    array<N> f;
+    array< triple<N, N, N> > t;
+    measure_orbit_structure_each_table() :
+        legend("orbit_structure(x, f) for all x of a random table of 100000"),
+            n(100000), t(n, n, triple<N, N, N>(0, 0, 0))
+    {
+        random_table(f, n);
+    }
+    inline void operator()() {
+        table_transformation<pointer(N)> g(begin(f), n);
+        table_transformation_definition_space_predicate<pointer(N)> p(g);
+        for (N x(0); x < n; x = successor(x))
+            t[x] = orbit_structure(x, g, p);
+    }
+};
+
+template<int threads>
+struct measure_orbit_structures_table
+{
+    typedef DistanceType(pointer(int)) N;
+    const pointer(char) legend;
+    N n;
+    array<N> f;
+    array< triple<N, N, N> > t;
+    measure_orbit_structures_table() :
+        legend(threads == 1 ?
+            "orbit_structures_table(f, 100000), 1 thread" :
+            "orbit_structures_table(f, 100000), 4 threads"),
+            n(100000), t(n, n, triple<N, N, N>(0, 0, 0))
+    {
+        random_table(f, n);
+    }
+    inline void operator()() {
+        orbit_structures_table(begin(f), n, begin(t), threads);
+    }
+};
+
+template<typename F>
+    requires(Transformation(F))
+void measure_orbit_structure_calls(const pointer(char) name, Domain(F) x, F f)
+{
+    typedef DistanceType(F) N;
+    typedef instrumented_transformation<F, pointer(N)> G;
+    N n0(0);
+    N n1(0);
+    N n2(0);
+    triple<N, N, Domain(F)> t0 =
+        orbit_structure(x, G(f, &n0), always_defined<Domain(F)>);
+    triple<N, N, Domain(F)> t1 =
+        orbit_structure_teleporting(x, G(f, &n1), always_defined<Domain(F)>);
+    triple<N, N, Domain(F)> t2 =
+        orbit_structure_distinguished(x, G(f, &n2), always_defined<Domain(F)>, 10);
+    Assert(t0 == t1);
+    Assert(t0 == t2);
+    print(name); print(": h = "); print(t0.m0);
+        print(", c-1 = "); print(t0.m1);
+            print("; orbit_structure "); print(n0);
+                print(", orbit_structure_teleporting "); print(n1);
+                    print(" calls of f; ratio = "); print(double(n0) / double(n1));
+                        print_eol();
+    print(name); print(": orbit_structure_distinguished(k = 10) "); print(n2);
+        print(" calls of f; ratio = "); print(double(n0) / double(n2));
+            print_eol();
+}
+
+void measure_orbit_structure_transformation_calls()
+{
+    measure_orbit_structure_calls("Lehmer 1949", lehmer_1949().x0, lehmer_1949());
+    measure_orbit_structure_calls("LCG(10007, 3, 1)", 0ll, LCG(10007ll, 3ll, 1ll, 0ll, ""));
+    measure_orbit_structure_calls("LCG(65536, 5, 0)", 3ll, LCG(65536ll, 5ll, 0ll, 3ll, ""));
+    measure_orbit_structure_calls("LCG(1000000, 11, 0)", 1000ll,
+                                  LCG(1000000ll, 11ll, 0ll, 1000ll, ""));
+    measure_orbit_structure_calls("LCG(1048576, 6, 1)", 0ll,
+                                  LCG(1048576ll, 6ll, 1ll, 0ll, ""));
+    measure_orbit_structure_calls("LCG(999999, 12, 7)", 5ll,
+                                  LCG(999999ll, 12ll, 7ll, 5ll, ""));
+}
+
 struct measure_reverse_bidirectional
 {
     const pointer(char) legend;
@@ -300,6 +1435,103 @@ void measure_sort_n_adaptive_compares()
     }
 }
 
+struct instrumented_odd
+{
+    bool operator()(const instrumented<int>& x)
+    {
+        return odd(x.value);
+    }
+};
+
+template<>
+struct input_type<instrumented_odd, 0>
+{
+    typedef instrumented<int> type;
+};
+
+const int instrumented_algorithms = 18;
+
+const pointer(char) instrumented_algorithm_name(int a)
+{
+    static const pointer(char) names[instrumented_algorithms] = {
+        "reverse_bidirectional", "reverse_n_indexed", "reverse_n_forward",
+        "reverse_n_with_buffer", "reverse_n_adaptive(n/8)",
+        "rotate(n/3)", "rotate_bidirectional", "rotate_forward",
+        "rotate_with_buffer",
+        "partition_semistable", "partition_bidirectional",
+        "partition_single_cycle", "partition_stable_n",
+        "partition_stable_with_buffer",
+        "sort_n", "sort_n_adaptive(n/8)", "sort_n_with_buffer",
+        "sort(slist)"
+    };
+    return names[a];
+}
+
+void run_instrumented_algorithm(int a, pointer(instrumented<int>) f, int n,
+                                pointer(instrumented<int>) f_b)
+{
+    // Precondition: $[f, n)$ and $[f_b, n)$ are mutable counted ranges
+    typedef instrumented<int> T;
+    typedef less<T> R;
+    pointer(T) l = f + n;
+    pointer(T) m = f + n / 3;
+    switch (a) {
+    case 0: reverse_bidirectional(f, l); break;
+    case 1: reverse_n_indexed(f, n); break;
+    case 2: reverse_n_forward(f, n); break;
+    case 3: reverse_n_with_buffer(f, n, f_b); break;
+    case 4: reverse_n_adaptive(f, n, f_b, n / 8); break;
+    case 5: rotate(f, m, l); break;
+    case 6: rotate_bidirectional_nontrivial(f, m, l); break;
+    case 7: rotate_forward_nontrivial(f, m, l); break;
+    case 8: rotate_with_buffer_nontrivial(f, m, l, f_b); break;
+    case 9: partition_semistable(f, l, instrumented_odd()); break;
+    case 10: partition_bidirectional(f, l, instrumented_odd()); break;
+    case 11: partition_single_cycle(f, l, instrumented_odd()); break;
+    case 12: partition_stable_n(f, n, instrumented_odd()); break;
+    case 13: partition_stable_with_buffer(f, l, f_b, instrumented_odd()); break;
+    case 14: sort_n(f, n, R()); break;
+    case 15: sort_n_adaptive(f, n, f_b, n / 8, R()); break;
+    case 16: sort_n_with_buffer(f, n, f_b, R()); break;
+    case 17: { // including building and destroying the list
+        slist<T> x(counted_range<pointer(T)>(f, n));
+        sort(x, R());
+        break;
+    }
+    }
+}
+
+void measure_instrumented()
+{
+    // Operations per element on a random permutation of $[0, n)$
+    typedef instrumented<int> T;
+    typedef instrumented_base B;
+    printf("%-30s %7s", "algorithm", B::name(B::n));
+    for (int i = 1; i < B::number_ops; i = successor(i))
+        printf(" %9s", B::name(i));
+    print_eol();
+    for (int a = 0; a < instrumented_algorithms; a = successor(a)) {
+        for (int n = 16; n <= 65536; n = 16 * n) {
+            array<T> x(n, n, T(0));
+            array<T> b(n, n, T(0));
+            unsigned u = 1u;
+            for (int i = 0; i < n; i = successor(i)) {
+                u = u * 1103515245u + 12345u;
+                int j = int((u >> 8) % unsigned(i + 1));
+                x[i].value = x[j].value;
+                x[j].value = i;
+            }
+            B::initialize(n);
+            run_instrumented_algorithm(a, begin(x), n, begin(b));
+            pointer(double) c = B::counts();
+            printf("%-30s %7.0f", instrumented_algorithm_name(a), c[B::n]);
+            for (int i = 1; i < B::number_ops; i = successor(i))
+                printf(" %9.3f", c[i] / c[B::n]);
+            print_eol();
+        }
+    }
+}
+
 struct measure_sort_n_adaptive
 {
     const pointer(char) legend;
@@ -347,8 +1579,124 @@ void run_measurements()
     report(perform<M, measure_sort_linked>());
     report(perform<M, measure_sort_n_adaptive>());
     measure_sort_n_adaptive_compares();
+    measure_instrumented();
     report(perform<M, measure_clock>());
     report(perform<M, measure_gcd>());
+    report(perform<M, measure_gcd_lazy_rational>());
+    report(perform<M, measure_rational_sum<0> >());
+    report(perform<M, measure_rational_sum<1> >());
+    report(perform<M, measure_rational_sum<2> >());
+    report(perform<M, measure_rational_sum<3> >());
+    report(perform<M, measure_gcd_integer<0, false> >());
+    report(perform<M, measure_gcd_integer<1, false> >());
+    report(perform<M, measure_gcd_integer<2, false> >());
+    report(perform<M, measure_gcd_integer<0, true> >());
+    report(perform<M, measure_gcd_integer<1, true> >());
+    report(perform<M, measure_gcd_integer<2, true> >());
+    report(perform<M, measure_gcd_n<int, 0> >());
+    report(perform<M, measure_gcd_n<int, 1> >());
+    report(perform<M, measure_gcd_n<int, 2> >());
+    report(perform<M, measure_gcd_n<int, 3> >());
+    report(perform<M, measure_gcd_n<int, 4> >());
+    report(perform<M, measure_gcd_n<long long, 0> >());
+    report(perform<M, measure_gcd_n<long long, 1> >());
+    report(perform<M, measure_gcd_n<long long, 2> >());
+    report(perform<M, measure_gcd_n<long long, 3> >());
+    report(perform<M, measure_gcd_n<long long, 4> >());
+    measure_orbit_structure_transformation_calls();
+    report(perform<M, measure_power_unary_stepwise>());
+    report(perform<M, measure_power_unary_composable>());
+    measure_power_chain_operations();
+    report(perform<M, measure_power_constant<15, false> >());
+    report(perform<M, measure_power_constant<15, true> >());
+    report(perform<M, measure_power_constant<255, false> >());
+    report(perform<M, measure_power_constant<255, true> >());
+    report(perform<M, measure_power_constant<1023, false> >());
+    report(perform<M, measure_power_constant<1023, true> >());
+    measure_power_windowed_operations();
+    report(perform<M, measure_power_windowed<0> >());
+    report(perform<M, measure_power_windowed<1> >());
+    report(perform<M, measure_power_windowed<2> >());
+    report(perform<M, measure_limbs_multiply<false> >());
+    report(perform<M, measure_limbs_multiply<true> >());
+    report(perform<M, measure_fibonacci_big_integer<100000> >());
+    report(perform<M, measure_fibonacci_big_integer<1000000> >());
+    report(perform<M, measure_fibonacci_big_integer<10000000> >());
+    report(perform<M, measure_power_big_integer>());
+    report(perform<M, measure_extended_gcd<16, false> >());
+    report(perform<M, measure_extended_gcd<16, true> >());
+    report(perform<M, measure_extended_gcd<64, false> >());
+    report(perform<M, measure_extended_gcd<64, true> >());
+    report(perform<M, measure_extended_gcd<256, false> >());
+    report(perform<M, measure_extended_gcd<256, true> >());
+    report(perform<M, measure_quotient_remainder_invariant<int, false> >());
+    report(perform<M, measure_quotient_remainder_invariant<int, true> >());
+    report(perform<M, measure_quotient_remainder_invariant<long long, false> >());
+    report(perform<M, measure_quotient_remainder_invariant<long long, true> >());
+    report(perform<M, measure_polynomial_product<0> >());
+    report(perform<M, measure_polynomial_product<1> >());
+    report(perform<M, measure_polynomial_product<2> >());
+    report(perform<M, measure_polynomial_product<3> >());
+    report(perform<M, measure_polynomial_division<false> >());
+    report(perform<M, measure_polynomial_division<true> >());
+    report(perform<M, measure_polynomial_evaluate<double, false> >());
+    report(perform<M, measure_polynomial_evaluate<double, true> >());
+    report(perform<M, measure_polynomial_evaluate<modular_integer<998244353u>, false> >());
+    report(perform<M, measure_polynomial_evaluate<modular_integer<998244353u>, true> >());
+    report(perform<M, measure_sparse_polynomial<0> >());
+    report(perform<M, measure_sparse_polynomial<1> >());
+    report(perform<M, measure_sparse_polynomial<2> >());
+    report(perform<M, measure_sparse_polynomial<3> >());
+    report(perform<M, measure_search<0> >());
+    report(perform<M, measure_search<1> >());
+    report(perform<M, measure_search<2> >());
+    report(perform<M, measure_reduce_balanced<1> >());
+    report(perform<M, measure_reduce_balanced<2> >());
+    report(perform<M, measure_reduce_balanced<4> >());
+    report(perform<M, measure_quantifiers<char, false> >());
+    report(perform<M, measure_quantifiers<char, true> >());
+    report(perform<M, measure_quantifiers<int, false> >());
+    report(perform<M, measure_quantifiers<int, true> >());
+    report(perform<M, measure_quantifiers<double, false> >());
+    report(perform<M, measure_quantifiers<double, true> >());
+    report(perform<M, measure_multiplies_modulo<0, false> >());
+    report(perform<M, measure_multiplies_modulo<1, false> >());
+    report(perform<M, measure_multiplies_modulo<2, false> >());
+    report(perform<M, measure_multiplies_modulo<3, false> >());
+    report(perform<M, measure_multiplies_modulo<1, true> >());
+    report(perform<M, measure_multiplies_modulo<2, true> >());
+    report(perform<M, measure_multiplies_modulo<3, true> >());
+    report(perform<M, measure_power_modulo<1> >());
+    report(perform<M, measure_power_modulo<2> >());
+    report(perform<M, measure_power_modulo<3> >());
+    measure_select_comparisons();
+    report(perform<M, measure_select_2_5<false> >());
+    report(perform<M, measure_select_2_5<true> >());
+    report(perform<M, measure_median_5_filter<false> >());
+    report(perform<M, measure_median_5_filter<true> >());
+    report(perform<M, measure_matrix_multiply<false> >());
+    report(perform<M, measure_matrix_multiply<true> >());
+    report(perform<M, measure_matrix_power<0> >());
+    report(perform<M, measure_matrix_power<128> >());
+    report(perform<M, measure_orbit_structure>());
+    report(perform<M, measure_orbit_structure_checkpointed<10> >());
+    report(perform<M, measure_orbit_structure_checkpointed<16> >());
+    report(perform<M, measure_orbit_structure_checkpointed<22> >());
+    report(perform<M, measure_orbit_structure_teleporting>());
+    report(perform<M, measure_orbit_structure_distinguished>());
+    report(perform<M, measure_orbit_structure_parallel<1> >());
+    report(perform<M, measure_orbit_structure_parallel<4> >());
+    report(perform<M, measure_orbit_structures_lcg>());
+    report(perform<M, measure_orbit_structure_distinguished_n<1> >());
+    report(perform<M, measure_orbit_structure_distinguished_n<4> >());
+    report(perform<M, measure_orbit_structure_each_affine>());
+    report(perform<M, measure_orbit_structure_lanes<1, int> >());
+    report(perform<M, measure_orbit_structure_lanes<8, int> >());
+    report(perform<M, measure_orbit_structure_lanes<1, long long> >());
+    report(perform<M, measure_orbit_structure_lanes<8, long long> >());
+    report(perform<M, measure_orbit_structure_each_table>());
+    report(perform<M, measure_orbit_structures_table<1> >());
+    report(perform<M, measure_orbit_structures_table<4> >());
     report(perform<M, measure_reverse_bidirectional>());
     measure_reverse_algorithms();
 }
@@ -0,0 +1,753 @@
+// multiprecision.h
+
+// Copyright (c) 2009 Alexander Stepanov and Paul McJones
+//
+// Permission to use, copy, modify, distribute and sell this software
+// and its documentation for any purpose is hereby granted without
+// fee, provided that the above copyright notice appear in all copies
+// and that both that copyright notice and this permission notice
+// appear in supporting documentation. The authors make no
+// representations about the suitability of this software for any
+// purpose. It is provided "as is" without express or implied
+// warranty.
+
+
+// Multiprecision integers modeling Integer from
+// Elements of Programming
+// by Alexander Stepanov and Paul McJones
+// Addison-Wesley Professional, 2009
+
+
+#ifndef EOP_MULTIPRECISION
+#define EOP_MULTIPRECISION
+
+
+#include "intrinsics.h"
+#include "type_functions.h"
+#include "eop.h"
+#include "print.h"
+
+#include <cstdlib> // malloc, free
+
+
+// Magnitudes
+
+// A magnitude is a sequence of limbs, least significant first, passed as
+// a pointer and a length. The procedures on magnitudes work in place on
+// caller-provided storage and return the length of the result, with no
+// leading zero limbs unless noted otherwise
+
+typedef unsigned long long limb;
+typedef unsigned __int128 double_limb;
+
+const int limb_bits = 64;
+
+// Products of magnitudes with at least this many limbs use Karatsuba
+// multiplication
+const int karatsuba_threshold = 24;
+
+pointer(limb) allocate_limbs(int n)
+{
+    typedef pointer(limb) P;
+    return P(malloc(n * sizeof(limb)));
+}
+
+void deallocate_limbs(pointer(limb) p)
+{
+    free(p);
+}
+
+int limbs_normalize(const pointer(limb) a, int n)
+{
+    // Returns $n$ less the leading zero limbs of $a$
+    while (n > 0 && a[n - 1] == 0) n = predecessor(n);
+    return n;
+}
+
+int limbs_compare(const pointer(limb) a, int na, const pointer(limb) b, int nb)
+{
+    // Precondition: $a$ and $b$ are normalized
+    if (na != nb) return na < nb ? -1 : 1;
+    while (na > 0) {
+        na = predecessor(na);
+        if (a[na] != b[na]) return a[na] < b[na] ? -1 : 1;
+    }
+    return 0;
+}
+
+int limbs_add(const pointer(limb) a, int na, const pointer(limb) b, int nb,
+              pointer(limb) r)
+{
+    // Precondition: $na \geq nb \wedge r$ has room for $na + 1$ limbs
+    // $r$ may be $a$
+    limb carry(0);
+    int i(0);
+    while (i < nb) {
+        limb s = a[i] + carry;
+        carry = limb(s < carry);
+        r[i] = s + b[i];
+        carry = carry + limb(r[i] < s);
+        i = successor(i);
+    }
+    while (i < na) {
+        r[i] = a[i] + carry;
+        carry = limb(r[i] < carry);
+        i = successor(i);
+    }
+    r[na] = carry;
+    return na + int(carry);
+}
+
+int limbs_subtract(const pointer(limb) a, int na, const pointer(limb) b, int nb,
+                   pointer(limb) r)
+{
+    // Precondition: $a \geq b \wedge na \geq nb$; $r$ may be $a$
+    limb borrow(0);
+    int i(0);
+    while (i < nb) {
+        limb d = a[i] - borrow;
+        borrow = limb(a[i] < borrow);
+        r[i] = d - b[i];
+        borrow = borrow + limb(d < b[i]);
+        i = successor(i);
+    }
+    while (i < na) {
+        limb d = a[i];
+        r[i] = d - borrow;
+        borrow = limb(d < borrow);
+        i = successor(i);
+    }
+    return limbs_normalize(r, na);
+}
+
+void limbs_add_to(pointer(limb) r, int nr, const pointer(limb) b, int nb)
+{
+    // Precondition: the sum fits in $nr \geq nb$ limbs
+    limb carry(0);
+    int i(0);
+    while (i < nb) {
+        limb s = r[i] + carry;
+        carry = limb(s < carry);
+        r[i] = s + b[i];
+        carry = carry + limb(r[i] < s);
+        i = successor(i);
+    }
+    while (carry != 0 && i < nr) {
+        r[i] = r[i] + carry;
+        carry = limb(r[i] == 0);
+        i = successor(i);
+    }
+}
+
+void limbs_multiply_schoolbook(const pointer(limb) a, int na,
+                               const pointer(limb) b, int nb, pointer(limb) r)
+{
+    // Postcondition: $r[0, na + nb)$ holds $a b$, not normalized
+    for (int i = 0; i < na + nb; i = successor(i)) r[i] = 0;
+    for (int i = 0; i < na; i = successor(i)) {
+        limb carry(0);
+        double_limb x = a[i];
+        for (int j = 0; j < nb; j = successor(j)) {
+            double_limb t = x * b[j] + r[i + j] + carry;
+            r[i + j] = limb(t);
+            carry = limb(t >> limb_bits);
+        }
+        r[i + nb] = carry;
+    }
+}
+
+void limbs_multiply(const pointer(limb) a, int na,
+                    const pointer(limb) b, int nb, pointer(limb) r)
+{
+    // Postcondition: $r[0, na + nb)$ holds $a b$, not normalized
+    // $r$ must not overlap $a$ or $b$
+    if (na < nb) {
+        limbs_multiply(b, nb, a, na, r);
+        return;
+    }
+    if (nb < karatsuba_threshold) {
+        limbs_multiply_schoolbook(a, na, b, nb, r);
+        return;
+    }
+    if (na >= twice(nb)) {
+        // Unbalanced: multiply $b$ by slices of $a$ of length $nb$
+        for (int i = 0; i < na + nb; i = successor(i)) r[i] = 0;
+        pointer(limb) t = allocate_limbs(2 * nb);
+        for (int i = 0; i < na; i = i + nb) {
+            int m = na - i < nb ? na - i : nb;
+            limbs_multiply(a + i, m, b, nb, t);
+            limbs_add_to(r + i, na + nb - i, t, m + nb);
+        }
+        deallocate_limbs(t);
+        return;
+    }
+    // Karatsuba: with $a = a_1 B^h + a_0$ and $b = b_1 B^h + b_0$,
+    // $a b = z_2 B^{2h} + (z_1 - z_2 - z_0) B^h + z_0$ where
+    // $z_2 = a_1 b_1$, $z_0 = a_0 b_0$ and $z_1 = (a_1 + a_0)(b_1 + b_0)$
+    int h = (na + 1) / 2;     // $nb > h$ since $na < 2 nb$
+    pointer(limb) s = allocate_limbs(6 * h + 6);
+    pointer(limb) sa = s;
+    pointer(limb) sb = s + (h + 1);
+    pointer(limb) z1 = s + 2 * (h + 1);
+    int na0 = limbs_normalize(a, h);
+    int nb0 = limbs_normalize(b, h);
+    int nsa = na0 >= na - h ? limbs_add(a, na0, a + h, na - h, sa)
+                            : limbs_add(a + h, na - h, a, na0, sa);
+    int nsb = nb0 >= nb - h ? limbs_add(b, nb0, b + h, nb - h, sb)
+                            : limbs_add(b + h, nb - h, b, nb0, sb);
+    limbs_multiply(a, h, b, h, r);                       // $z_0$
+    limbs_multiply(a + h, na - h, b + h, nb - h, r + twice(h)); // $z_2$
+    limbs_multiply(sa, nsa, sb, nsb, z1);
+    int nz1 = limbs_normalize(z1, nsa + nsb);
+    nz1 = limbs_subtract(z1, nz1, r, limbs_normalize(r, twice(h)), z1);
+    nz1 = limbs_subtract(z1, nz1, r + twice(h),
+                         limbs_normalize(r + twice(h), na + nb - twice(h)), z1);
+    limbs_add_to(r + h, na + nb - h, z1, nz1);
+    deallocate_limbs(s);
+}
+
+limb limbs_divide_limb(const pointer(limb) a, int na, limb v, pointer(limb) q)
+{
+    // Precondition: $v \neq 0$; $q$ may be $a$
+    // Postcondition: $q[0, na)$ holds $a / v$, not normalized; returns $a \bmod v$
+    limb r(0);
+    while (na > 0) {
+        na = predecessor(na);
+        double_limb t = (double_limb(r) << limb_bits) | a[na];
+        q[na] = limb(t / v);
+        r = limb(t % v);
+    }
+    return r;
+}
+
+int limbs_leading_zeros(limb x)
+{
+    // Precondition: $x \neq 0$
+    int k(0);
+    while (!(x >> (limb_bits - 1))) { x = x << 1; k = successor(k); }
+    return k;
+}
+
+void limbs_divide(const pointer(limb) a, int na, const pointer(limb) b, int nb,
+                  pointer(limb) q, pointer(limb) r)
+{
+    // Precondition: $na \geq nb \geq 2 \wedge b[nb - 1] \neq 0$
+    // Postcondition: $q[0, na - nb + 1)$ holds $a / b$ and $r[0, nb)$ holds
+    //     $a \bmod b$, neither normalized
+    // Knuth, The Art of Computer Programming, volume 2, 4.3.1, Algorithm D
+    int k = limbs_leading_zeros(b[nb - 1]);
+    pointer(limb) u = allocate_limbs(na + 1 + nb);
+    pointer(limb) v = u + (na + 1);
+    for (int i = nb - 1; i > 0; i = predecessor(i))
+        v[i] = k == 0 ? b[i] : (b[i] << k) | (b[i - 1] >> (limb_bits - k));
+    v[0] = b[0] << k;
+    u[na] = k == 0 ? 0 : a[na - 1] >> (limb_bits - k);
+    for (int i = na - 1; i > 0; i = predecessor(i))
+        u[i] = k == 0 ? a[i] : (a[i] << k) | (a[i - 1] >> (limb_bits - k));
+    u[0] = a[0] << k;
+    for (int j = na - nb; j >= 0; j = predecessor(j)) {
+        double_limb t = (double_limb(u[j + nb]) << limb_bits) | u[j + nb - 1];
+        double_limb qhat = t / v[nb - 1];
+        double_limb rhat = t % v[nb - 1];
+        while (qhat >> limb_bits ||
+               qhat * v[nb - 2] > ((rhat << limb_bits) | u[j + nb - 2])) {
+            qhat = qhat - 1;
+            rhat = rhat + v[nb - 1];
+            if (rhat >> limb_bits) break;
+        }
+        // $u[j, j + nb] \leftarrow u[j, j + nb] - \hat{q} v$
+        limb borrow(0);
+        limb carry(0);
+        for (int i = 0; i < nb; i = successor(i)) {
+            double_limb p = qhat * v[i] + carry;
+            carry = limb(p >> limb_bits);
+            limb s = limb(p);
+            limb d = u[i + j] - s;
+            limb b1 = limb(u[i + j] < s);
+            u[i + j] = d - borrow;
+            borrow = b1 + limb(d < borrow);
+        }
+        limb d = u[j + nb] - carry;
+        limb b1 = limb(u[j + nb] < carry);
+        u[j + nb] = d - borrow;
+        borrow = b1 + limb(d < borrow);
+        if (borrow != 0) {
+            // $\hat{q}$ was one too large: add $v$ back
+            qhat = qhat - 1;
+            limb c(0);
+            for (int i = 0; i < nb; i = successor(i)) {
+                limb s = u[i + j] + c;
+                c = limb(s < c);
+                u[i + j] = s + v[i];
+                c = c + limb(u[i + j] < s);
+            }
+            u[j + nb] = u[j + nb] + c;
+        }
+        q[j] = limb(qhat);
+    }
+    for (int i = 0; i < nb; i = successor(i))
+        r[i] = k == 0 ? u[i] : (u[i] >> k) | (u[i + 1] << (limb_bits - k));
+    deallocate_limbs(u);
+}
+
+
+// Modular multiplication of limbs
+
+// $x y \bmod m$ for limbs, with the product held in a double limb so that
+// no modulus up to $2^{64}$ overflows. The hardware division of
+// $\func{multiplies\_modulo\_wide}$ is replaced by multiplications:
+// Barrett reduction multiplies by a precomputed reciprocal of the modulus,
+// shifted so that its top bit is set (the form of Moller and Granlund);
+// Montgomery reduction works on representatives $x 2^{64} \bmod m$, so a
+// power converts its argument once and its result once
+
+struct multiplies_modulo_wide
+{
+    limb m;
+    multiplies_modulo_wide(limb m) : m(m) { }
+    limb operator()(limb x, limb y) const
+    {
+        // Precondition: $m > 0$
+        return limb(double_limb(x) * y % m);
+    }
+};
+
+template<>
+struct input_type<multiplies_modulo_wide, 0>
+{
+    typedef limb type;
+};
+
+struct multiplies_modulo_barrett
+{
+    limb m;
+    int l;                     // leading zeros of $m$
+    limb d;                    // $m 2^l$
+    limb v;                    // $\lfloor (2^{128} - 1) / d \rfloor - 2^{64}$
+    multiplies_modulo_barrett(limb m) :
+        m(m), l(limbs_leading_zeros(m)), d(m << l),
+        v(limb(~double_limb(0) / d))
+    {
+        // Precondition: $m > 0$
+    }
+    limb reduce(double_limb p) const
+    {
+        // Precondition: $p < m 2^{64}$
+        // Returns $p \bmod m$
+        double_limb u = p << l;
+        limb u1 = limb(u >> limb_bits);
+        double_limb q = double_limb(v) * u1 + u;
+        limb r = limb(u) - (limb(q >> limb_bits) + 1) * d;
+        if (r > limb(q)) r = r + d;
+        if (r >= d)      r = r - d;
+        return r >> l;
+    }
+    limb operator()(limb x, limb y) const
+    {
+        // Precondition: $x < m \vee y < m$
+        return reduce(double_limb(x) * y);
+    }
+};
+
+template<>
+struct input_type<multiplies_modulo_barrett, 0>
+{
+    typedef limb type;
+};
+
+struct multiplies_modulo_montgomery
+{
+    // Operates on Montgomery representatives: $x \mapsto x 2^{64} \bmod m$
+    limb m;
+    limb k;                    // $-m^{-1} \bmod 2^{64}$
+    limb r2;                   // $2^{128} \bmod m$
+    multiplies_modulo_montgomery(limb m) : m(m)
+    {
+        // Precondition: $m$ is odd $\wedge m < 2^{63}$
+        limb v = m;            // $m v \equiv 1 \pmod{2^3}$
+        for (int i = 0; i < 5; i = successor(i)) v = v * (2 - m * v);
+        k = 0 - v;
+        r2 = limb((~double_limb(0) % m + 1) % m);
+    }
+    limb reduce(double_limb t) const
+    {
+        // Precondition: $t < m 2^{64}$
+        // Returns $t 2^{-64} \bmod m$
+        limb u = limb(t) * k;
+        limb r = limb((t + double_limb(u) * m) >> limb_bits);
+        return r >= m ? r - m : r;
+    }
+    limb operator()(limb x, limb y) const
+    {
+        // Precondition: $x, y < m$
+        return reduce(double_limb(x) * y);
+    }
+    limb to(limb x) const
+    {
+        return reduce(double_limb(x % m) * r2);
+    }
+    limb from(limb x) const
+    {
+        return reduce(x);
+    }
+};
+
+template<>
+struct input_type<multiplies_modulo_montgomery, 0>
+{
+    typedef limb type;
+};
+
+template<typename I>
+    requires(Integer(I))
+limb power_montgomery(limb a, I n, limb m)
+{
+    // Precondition: $\func{positive}(n) \wedge m$ is odd $\wedge m < 2^{63}$
+    // Postcondition: returns $a^n \bmod m$
+    multiplies_modulo_montgomery op(m);
+    return op.from(power(op.to(a), n, op));
+}
+
+// type big_integer
+// model Integer(big_integer)
+
+struct big_integer
+{
+    // Sign and magnitude; zero has no limbs and is not negative
+    pointer(limb) d;
+    int n;                     // limbs in use
+    int c;                     // capacity
+    bool s;                    // negative
+    big_integer() : d(0), n(0), c(0), s(false) { }
+    big_integer(int x) : d(0), n(0), c(0), s(false)
+    {
+        assign(x < 0 ? 0ull - (unsigned long long)(x) : (unsigned long long)(x), x < 0);
+    }
+    big_integer(long x) : d(0), n(0), c(0), s(false)
+    {
+        assign(x < 0 ? 0ull - (unsigned long long)(x) : (unsigned long long)(x), x < 0);
+    }
+    big_integer(long long x) : d(0), n(0), c(0), s(false)
+    {
+        assign(x < 0 ? 0ull - (unsigned long long)(x) : (unsigned long long)(x), x < 0);
+    }
+    big_integer(unsigned x) : d(0), n(0), c(0), s(false)
+    {
+        assign(x, false);
+    }
+    big_integer(unsigned long x) : d(0), n(0), c(0), s(false)
+    {
+        assign(x, false);
+    }
+    big_integer(unsigned long long x) : d(0), n(0), c(0), s(false)
+    {
+        assign(x, false);
+    }
+    explicit big_integer(const pointer(char) x) : d(0), n(0), c(0), s(false)
+    {
+        // Precondition: $x$ is an optionally negative decimal numeral
+        bool m = source(x) == '-';
+        if (m) x = x + 1;
+        while (source(x) != '\0') {
+            limb t = limb(source(x) - '0');
+            reserve(successor(n));
+            limb carry = t;
+            for (int i = 0; i < n; i = successor(i)) {
+                double_limb p = double_limb(d[i]) * 10u + carry;
+                d[i] = limb(p);
+                carry = limb(p >> limb_bits);
+            }
+            if (carry != 0) { d[n] = carry; n = successor(n); }
+            x = x + 1;
+        }
+        s = m && n != 0;
+    }
+    big_integer(const big_integer& x) : d(0), n(0), c(0), s(x.s)
+    {
+        reserve(x.n);
+        for (int i = 0; i < x.n; i = successor(i)) d[i] = x.d[i];
+        n = x.n;
+    }
+    void operator=(const big_integer& x)
+    {
+        if (this == &x) return;
+        reserve(x.n);
+        for (int i = 0; i < x.n; i = successor(i)) d[i] = x.d[i];
+        n = x.n;
+        s = x.s;
+    }
+    ~big_integer()
+    {
+        deallocate_limbs(d);
+    }
+    void reserve(int m)
+    {
+        // Postcondition: capacity is at least $m$; the limbs in use are kept
+        if (m <= c) return;
+        if (m < twice(c)) m = twice(c);
+        pointer(limb) e = allocate_limbs(m);
+        copy_n(d, n, e);
+        deallocate_limbs(d);
+        d = e;
+        c = m;
+    }
+    void assign(unsigned long long x, bool m)
+    {
+        n = 0;
+        s = m && x != 0;
+        if (x == 0) return;
+        reserve(1);
+        d[0] = x;
+        n = 1;
+    }
+    void normalize()
+    {
+        n = limbs_normalize(d, n);
+        if (n == 0) s = false;
+    }
+};
+
+template<>
+struct underlying_type<big_integer>
+{
+    typedef struct { pointer(limb) d; int n; int c; bool s; } type;
+};
+
+template<>
+struct quotient_type<big_integer>
+{
+    typedef big_integer type;
+};
+
+bool operator==(const big_integer& x, const big_integer& y)
+{
+    return x.s == y.s && limbs_compare(x.d, x.n, y.d, y.n) == 0;
+}
+
+bool operator<(const big_integer& x, const big_integer& y)
+{
+    if (x.s != y.s) return x.s;
+    int k = limbs_compare(x.d, x.n, y.d, y.n);
+    return x.s ? k > 0 : k < 0;
+}
+
+big_integer operator-(const big_integer& x)
+{
+    big_integer r(x);
+    r.s = !x.s && x.n != 0;
+    return r;
+}
+
+big_integer add_signed(const big_integer& x, const big_integer& y, bool ys)
+{
+    // Returns $x + y$ with the sign of $y$ taken as $ys$
+    big_integer r;
+    if (x.s == ys) {
+        r.reserve(successor(x.n > y.n ? x.n : y.n));
+        r.n = x.n >= y.n ? limbs_add(x.d, x.n, y.d, y.n, r.d)
+                         : limbs_add(y.d, y.n, x.d, x.n, r.d);
+        r.s = x.s;
+    } else {
+        int k = limbs_compare(x.d, x.n, y.d, y.n);
+        if (k == 0) return r;
+        r.reserve(x.n > y.n ? x.n : y.n);
+        if (k > 0) { r.n = limbs_subtract(x.d, x.n, y.d, y.n, r.d); r.s = x.s; }
+        else       { r.n = limbs_subtract(y.d, y.n, x.d, x.n, r.d); r.s = ys; }
+    }
+    r.normalize();
+    return r;
+}
+
+big_integer operator+(const big_integer& x, const big_integer& y)
+{
+    return add_signed(x, y, y.s);
+}
+
+big_integer operator-(const big_integer& x, const big_integer& y)
+{
+    return add_signed(x, y, !y.s && y.n != 0);
+}
+
+big_integer operator*(const big_integer& x, const big_integer& y)
+{
+    big_integer r;
+    if (x.n == 0 || y.n == 0) return r;
+    r.reserve(x.n + y.n);
+    limbs_multiply(x.d, x.n, y.d, y.n, r.d);
+    r.n = x.n + y.n;
+    r.s = x.s != y.s;
+    r.normalize();
+    return r;
+}
+
+pair<big_integer, big_integer> quotient_remainder(const big_integer& x,
+                                                  const big_integer& y)
+{
+    // Precondition: $y \neq 0$
+    // Postcondition: the quotient is truncated toward zero and the
+    //     remainder has the sign of $x$, as for built-in integers
+    big_integer q;
+    big_integer r;
+    if (limbs_compare(x.d, x.n, y.d, y.n) < 0) {
+        r = x;
+    } else if (y.n == 1) {
+        q.reserve(x.n);
+        r.assign(limbs_divide_limb(x.d, x.n, y.d[0], q.d), false);
+        q.n = x.n;
+    } else {
+        q.reserve(x.n - y.n + 1);
+        r.reserve(y.n);
+        limbs_divide(x.d, x.n, y.d, y.n, q.d, r.d);
+        q.n = x.n - y.n + 1;
+        r.n = y.n;
+    }
+    q.s = x.s != y.s;
+    r.s = x.s;
+    q.normalize();
+    r.normalize();
+    return pair<big_integer, big_integer>(q, r);
+}
+
+big_integer operator/(const big_integer& x, const big_integer& y)
+{
+    return quotient_remainder(x, y).m0;
+}
+
+big_integer operator%(const big_integer& x, const big_integer& y)
+{
+    return quotient_remainder(x, y).m1;
+}
+
+
+// Special-case Integer procedures (see integers.h)
+
+big_integer successor(const big_integer& a)
+{
+    return a + big_integer(1);
+}
+
+big_integer predecessor(const big_integer& a)
+{
+    return a - big_integer(1);
+}
+
+big_integer twice(const big_integer& a)
+{
+    return a + a;
+}
+
+big_integer binary_scale_down_nonnegative(const big_integer& a, int k)
+{
+    // Precondition: $a \geq 0 \wedge k \geq 0$
+    int w = k / limb_bits;
+    int b = k % limb_bits;
+    big_integer r;
+    if (w >= a.n) return r;
+    r.reserve(a.n - w);
+    for (int i = w; i < a.n; i = successor(i)) {
+        limb x = a.d[i] >> b;
+        if (b != 0 && successor(i) < a.n) x = x | (a.d[i + 1] << (limb_bits - b));
+        r.d[i - w] = x;
+    }
+    r.n = a.n - w;
+    r.normalize();
+    return r;
+}
+
+big_integer binary_scale_down_nonnegative(const big_integer& a,
+                                          const big_integer& k)
+{
+    return binary_scale_down_nonnegative(a, k.n == 0 ? 0 : int(k.d[0]));
+}
+
+big_integer binary_scale_up_nonnegative(const big_integer& a, int k)
+{
+    // Precondition: $a \geq 0 \wedge k \geq 0$
+    int w = k / limb_bits;
+    int b = k % limb_bits;
+    big_integer r;
+    if (a.n == 0) return r;
+    r.reserve(a.n + w + 1);
+    for (int i = 0; i < w; i = successor(i)) r.d[i] = 0;
+    limb carry(0);
+    for (int i = 0; i < a.n; i = successor(i)) {
+        r.d[i + w] = (a.d[i] << b) | carry;
+        carry = b == 0 ? 0 : a.d[i] >> (limb_bits - b);
+    }
+    r.d[a.n + w] = carry;
+    r.n = a.n + w + 1;
+    r.normalize();
+    return r;
+}
+
+big_integer binary_scale_up_nonnegative(const big_integer& a,
+                                        const big_integer& k)
+{
+    return binary_scale_up_nonnegative(a, k.n == 0 ? 0 : int(k.d[0]));
+}
+
+big_integer half_nonnegative(const big_integer& a)
+{
+    return binary_scale_down_nonnegative(a, 1);
+}
+
+big_integer half(const big_integer& a)
+{
+    return half_nonnegative(a);
+}
+
+bool positive(const big_integer& a)
+{
+    return a.n != 0 && !a.s;
+}
+
+bool negative(const big_integer& a)
+{
+    return a.s;
+}
+
+bool zero(const big_integer& a)
+{
+    return a.n == 0;
+}
+
+bool one(const big_integer& a)
+{
+    return a.n == 1 && a.d[0] == 1 && !a.s;
+}
+
+bool even(const big_integer& a)
+{
+    return a.n == 0 || (a.d[0] & 1) == 0;
+}
+
+bool odd(const big_integer& a)
+{
+    return !even(a);
+}
+
+void print(const big_integer& x)
+{
+    // Decimal, by repeated division by $10^{19}$
+    const limb p = 10000000000000000000ull;
+    if (x.n == 0) { print("0"); return; }
+    if (x.s) print("-");
+    big_integer q(x);
+    int m = (x.n * 20) / 19 + 1;
+    pointer(limb) t = allocate_limbs(m);
+    int k(0);
+    while (q.n != 0) {
+        t[k] = limbs_divide_limb(q.d, q.n, p, q.d);
+        q.normalize();
+        k = successor(k);
+    }
+    k = predecessor(k);
+    printf("%llu", t[k]);
+    while (k > 0) {
+        k = predecessor(k);
+        printf("%019llu", t[k]);
+    }
+    deallocate_limbs(t);
+}
+
+#endif // EOP_MULTIPRECISION
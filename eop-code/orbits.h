@@ -0,0 +1,1275 @@
+// orbits.h
+
+// Copyright (c) 2009 Alexander Stepanov and Paul McJones
+//
+// Permission to use, copy, modify, distribute and sell this software
+// and its documentation for any purpose is hereby granted without
+// fee, provided that the above copyright notice appear in all copies
+// and that both that copyright notice and this permission notice
+// appear in supporting documentation. The authors make no
+// representations about the suitability of this software for any
+// purpose. It is provided "as is" without express or implied
+// warranty.
+
+
+// Orbit analysis engines extending Chapter 2 of
+// Elements of Programming
+// by Alexander Stepanov and Paul McJones
+// Addison-Wesley Professional, 2009
+
+
+#ifndef EOP_ORBITS
+#define EOP_ORBITS
+
+
+#include "intrinsics.h"
+#include "type_functions.h"
+#include "eop.h"
+#include "powers.h" // plus_modulo_no_overflow, multiply_modulo_no_overflow
+
+#include <cstdio> // fopen, fread, fwrite, rename, remove
+
+
+// Composable transformations
+
+// A transformation type $F$ whose $\func{TransformationConcept}$ is
+// $\type{composable\_transformation\_tag}$ provides $\func{compose}(f, g)$,
+// a transformation of type $F$ such that $\func{compose}(f, g)(x) = f(g(x))$.
+// Composition is associative, so $f^n$ takes $O(\log n)$ compositions
+// with $\func{power}$ from Chapter 3.
+
+template<typename F>
+    requires(Transformation(F))
+struct composition
+{
+    F operator()(const F& f, const F& g)
+    {
+        return compose(f, g);
+    }
+};
+
+template<typename F>
+    requires(Transformation(F))
+struct input_type<composition<F>, 0>
+{
+    typedef F type;
+};
+
+template<typename F, typename N>
+    requires(Transformation(F) && Integer(N))
+Domain(F) power_unary(Domain(F) x, N n, F f, composable_transformation_tag)
+{
+    // Precondition:
+    // $n \geq 0 \wedge (\forall i \in N)\,0 < i \leq n \Rightarrow f^i(x)$ is defined
+    if (zero(n)) return x;
+    return power(f, n, composition<F>())(x);
+}
+
+template<typename F>
+    requires(Transformation(F))
+pair<DistanceType(F), Domain(F)>
+convergent_point_distance(Domain(F) x0, Domain(F) x1, F f,
+                          composable_transformation_tag)
+{
+    // Precondition: $(\exists n \in \func{DistanceType}(F))\,n \geq 0 \wedge f^n(x0) = f^n(x1)$
+    // Postcondition: returns $(n, y)$ where $n$ is the least such and
+    // $y = f^n(x0)$
+    typedef DistanceType(F) N;
+    typedef DistanceType(pointer(F)) S;
+    if (x0 == x1) return pair<N, Domain(F)>(N(0), x0);
+    array<F> g;                // $g_j = f^{2^j}$
+    push(g, f);
+    N e(1);                    // $e = 2^j$ for the last $g_j$
+    while (true) {
+        F h = g[predecessor(size(g))];
+        if (h(x0) == h(x1)) break;
+        push(g, compose(h, h));
+        e = twice(e);
+    }
+    // Descend as in binary search, keeping $x0 \neq x1$ and
+    // $f^{2^j}(x0) = f^{2^j}(x1)$; $x0$ is $n$ steps from the start
+    N n(0);
+    S j = predecessor(size(g));
+    while (!zero(j)) {
+        j = predecessor(j);
+        e = half_nonnegative(e);
+        Domain(F) y0 = g[j](x0);
+        Domain(F) y1 = g[j](x1);
+        if (y0 != y1) {
+            x0 = y0;
+            x1 = y1;
+            n = n + e;
+        }
+    }
+    return pair<N, Domain(F)>(successor(n), f(x0));
+}
+
+template<typename F>
+    requires(Transformation(F))
+Domain(F) convergent_point(Domain(F) x0, Domain(F) x1, F f,
+                           composable_transformation_tag)
+{
+    // Precondition: $(\exists n \in \func{DistanceType}(F))\,n \geq 0 \wedge f^n(x0) = f^n(x1)$
+    return convergent_point_distance(x0, x1, f,
+                                     composable_transformation_tag()).m1;
+}
+
+// Affine transformations
+
+template<typename I>
+    requires(Integer(I))
+struct affine_transformation
+{
+    // $x \mapsto (a x + b) \bmod m$ on $[0, m)$
+    I a;
+    I b;
+    I m;
+    affine_transformation(I a, I b, I m) : a(a), b(b), m(m)
+    {
+        // Precondition: $0 \leq a, b < m$
+    }
+    I operator()(I x)
+    {
+        plus_modulo_no_overflow<I> plus(m);
+        return plus(multiply_modulo_no_overflow(a, x, m), b);
+    }
+};
+
+template<typename I>
+    requires(Integer(I))
+struct input_type<affine_transformation<I>, 0>
+{
+    typedef I type;
+};
+
+template<typename I>
+    requires(Integer(I))
+struct distance_type< affine_transformation<I> >
+{
+    typedef DistanceType(I) type;
+};
+
+template<typename I>
+    requires(Integer(I))
+struct transformation_concept< affine_transformation<I> >
+{
+    typedef composable_transformation_tag concept;
+};
+
+template<typename I>
+    requires(Integer(I))
+bool operator==(const affine_transformation<I>& f,
+                const affine_transformation<I>& g)
+{
+    return f.a == g.a && f.b == g.b && f.m == g.m;
+}
+
+template<typename I>
+    requires(Integer(I))
+affine_transformation<I> compose(const affine_transformation<I>& f,
+                                 const affine_transformation<I>& g)
+{
+    // Precondition: $f.m = g.m$
+    // $f(g(x)) = f.a (g.a x + g.b) + f.b$
+    plus_modulo_no_overflow<I> plus(f.m);
+    return affine_transformation<I>(
+        multiply_modulo_no_overflow(f.a, g.a, f.m),
+        plus(multiply_modulo_no_overflow(f.a, g.b, f.m), f.b),
+        f.m);
+}
+
+
+// Hashing and an open addressing table for integral keys
+
+
+template<typename T>
+    requires(Integer(T))
+unsigned long long hash_value(const T& x)
+{
+    // splitmix64 finalizer: every input bit affects every output bit
+    unsigned long long z = (unsigned long long)(x);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+template<typename T, typename V>
+    requires(Integer(T) && Regular(V))
+struct hash_table
+{
+    typedef DistanceType(pointer(T)) N;
+    array<T> keys;
+    array<V> values;
+    array<bool> occupied;
+    N count;
+    hash_table(N c = N(16))
+        : keys(c, c, T(0)), values(c, c, V()), occupied(c, c, false),
+          count(0)
+    {
+        // Precondition: $c$ is a power of 2
+    }
+};
+
+template<typename T, typename V>
+    requires(Integer(T) && Regular(V))
+DistanceType(pointer(T)) hash_slot(const hash_table<T, V>& h, const T& x)
+{
+    typedef DistanceType(pointer(T)) N;
+    N m = predecessor(size(h.keys));
+    N i = N(hash_value(x) & (unsigned long long)(m));
+    while (h.occupied[i] && h.keys[i] != x) i = (i + N(1)) & m;
+    return i;
+}
+
+template<typename T, typename V>
+    requires(Integer(T) && Regular(V))
+pointer(V) lookup(hash_table<T, V>& h, const T& x)
+{
+    DistanceType(pointer(T)) i = hash_slot(h, x);
+    if (!h.occupied[i]) return 0;
+    return &h.values[i];
+}
+
+template<typename T, typename V>
+    requires(Integer(T) && Regular(V))
+bool insert(hash_table<T, V>& h, const T& x, const V& v)
+{
+    // Postcondition: returns false and leaves $h$ unchanged if $x$ was present
+    typedef DistanceType(pointer(T)) N;
+    if (!(twice(successor(h.count)) <= size(h.keys))) {
+        hash_table<T, V> g(twice(size(h.keys)));
+        for (N i(0); i < size(h.keys); i = successor(i))
+            if (h.occupied[i]) insert(g, h.keys[i], h.values[i]);
+        swap(h.keys, g.keys);
+        swap(h.values, g.values);
+        swap(h.occupied, g.occupied);
+    }
+    N i = hash_slot(h, x);
+    if (h.occupied[i]) return false;
+    h.keys[i] = x;
+    h.values[i] = v;
+    h.occupied[i] = true;
+    h.count = successor(h.count);
+    return true;
+}
+
+
+// Distinguished point orbit analysis
+
+// A distinguished point is one whose hash has $k$ leading zero bits, so
+// on average one point in $2^k$ is distinguished, independently of how
+// the values of the orbit are distributed. Only distinguished points are
+// remembered, which bounds memory by the orbit size divided by $2^k$,
+// and lets walks from different starting points detect that they have
+// merged into an orbit already analyzed.
+// See:
+//   Paul C. van Oorschot and Michael J. Wiener.
+//   Parallel collision search with cryptanalytic applications.
+//   Journal of Cryptology 12(1):1-28, 1999.
+
+template<typename T>
+    requires(Integer(T))
+struct distinguished_point
+{
+    unsigned long long mask;
+    distinguished_point(int k) : mask(zero(k) ? 0ull : ~0ull << (64 - k))
+    {
+        // Precondition: $0 \leq k < 64$
+    }
+    bool operator()(const T& x)
+    {
+        return zero(hash_value(x) & mask);
+    }
+};
+
+template<typename T>
+    requires(Integer(T))
+struct input_type<distinguished_point<T>, 0>
+{
+    typedef T type;
+};
+
+template<typename T, typename N>
+    requires(Regular(T) && Integer(N))
+struct distinguished_point_entry
+{
+    // A handle entry describes a distinguished point at distance $m$ from
+    // the connection point $y$ of an orbit whose cycle size is $c + 1$.
+    // A cyclic entry describes a distinguished point on a cycle of size
+    // $c + 1$ whose previous distinguished point $y$ is at distance $m$.
+    bool cyclic;
+    N m;
+    N c;
+    T y;
+    distinguished_point_entry() : cyclic(false), m(0), c(0), y() { }
+    distinguished_point_entry(bool cyclic, N m, N c, const T& y)
+        : cyclic(cyclic), m(m), c(c), y(y) { }
+};
+
+template<typename T, typename N>
+    requires(Regular(T) && Integer(N))
+bool operator==(const distinguished_point_entry<T, N>& x,
+                const distinguished_point_entry<T, N>& y)
+{
+    return x.cyclic == y.cyclic && x.m == y.m && x.c == y.c && x.y == y.y;
+}
+
+template<typename F>
+    requires(Transformation(F) && Integer(Domain(F)))
+struct distinguished_point_registry
+{
+    // Shared by concurrent walks; all accesses hold $mutex$
+    hash_table< Domain(F), distinguished_point_entry<Domain(F), DistanceType(F)> > entries;
+    std::mutex mutex;
+};
+
+template<typename F>
+    requires(Transformation(F))
+pair<DistanceType(F), Domain(F)>
+convergent_point_distance(Domain(F) x0, DistanceType(F) d0,
+                          Domain(F) x1, DistanceType(F) d1, F f)
+{
+    // Precondition: $f^{d0}(x0) = f^{d1}(x1)$
+    // Postcondition: returns $(n, y)$ where $y = f^n(x0)$ is the first
+    // point of the orbit of $x0$ reached from $x1$ at the same distance
+    // from their common point
+    typedef DistanceType(F) N;
+    N n(0);
+    if      (d1 < d0) { n = d0 - d1; x0 = power_unary(x0, n, f); }
+    else if (d0 < d1) x1 = power_unary(x1, d1 - d0, f);
+    while (x0 != x1) {
+        x0 = f(x0);
+        x1 = f(x1);
+        n = successor(n);
+    }
+    return pair<N, Domain(F)>(n, x0);
+}
+
+template<typename F>
+    requires(Transformation(F))
+DistanceType(F)
+distinguished_connection(const Domain(F)& x,
+                         const array<Domain(F)>& q,
+                         const array<DistanceType(F)>& iq,
+                         DistanceType(pointer(Domain(F))) s,
+                         DistanceType(F) j,
+                         const distinguished_point_entry<Domain(F), DistanceType(F)>& e,
+                         F f, Domain(F)& y)
+{
+    // Precondition: $q_0, \ldots, q_{s-1}$ are the distinguished points at
+    // indices $iq_0 < \ldots < iq_{s-1}$ of the orbit of $x$ that are
+    // not on its cycle, and $e$ describes the first distinguished point
+    // on the cycle, at index $j$
+    // Postcondition: returns the index of the connection point $y$
+    typedef DistanceType(F) N;
+    Domain(F) a = x;
+    N i(0);
+    if (!zero(s)) {
+        a = q[predecessor(s)];
+        i = iq[predecessor(s)];
+    }
+    // The walk from $a$ enters the cycle without meeting a distinguished
+    // point, and the walk from $e.y$ covers the part of the cycle before
+    // the first distinguished point, so they merge at the connection point
+    pair<N, Domain(F)> r = convergent_point_distance(a, j - i, e.y, e.m, f);
+    y = r.m1;
+    return i + r.m0;
+}
+
+template<typename F, typename P>
+    requires(Transformation(F) && Integer(Domain(F)) &&
+        UnaryPredicate(P) && Domain(F) == Domain(P))
+triple<DistanceType(F), DistanceType(F), Domain(F)>
+orbit_structure_distinguished(const Domain(F)& x, F f, P p, int k,
+    pointer(distinguished_point_registry<F>) r)
+{
+    // Precondition: $p(x) \Leftrightarrow \text{$f(x)$ is defined}$
+    typedef Domain(F) T;
+    typedef DistanceType(F) N;
+    typedef DistanceType(pointer(T)) S;
+    typedef distinguished_point_entry<T, N> E;
+    distinguished_point<T> d(k);
+    array<T> q;                // distinguished points visited, in order
+    array<N> iq;               // $q_u = f^{iq_u}(x)$
+    hash_table<T, S> seen;     // $q_u \mapsto u$
+    triple<N, N, T> t;
+    bool cycle_found = false;  // the cycle was not in the registry
+    S u(0);                    // first distinguished point on the cycle
+    T w = x;                   // $w = f^{iw}(x)$, teleported as in
+    N iw(0);                   // $\func{orbit\_structure\_teleporting}$ to
+    N lim(1);                  // detect a cycle without distinguished points
+    T y = x;
+    N i(0);
+    while (true) {             // $y = f^i(x)$
+        if (!p(y)) {
+            t = triple<N, N, T>(i, N(0), y);
+            break;
+        }
+        if (d(y)) {
+            if (r != 0) {
+                S s = size(q);
+                E e;
+                bool found = false;
+                {
+                    std::lock_guard<std::mutex> lock(sink(r).mutex);
+                    pointer(E) h = lookup(sink(r).entries, y);
+                    if (h != 0) {
+                        found = true;
+                        e = source(h);
+                        // Skip back over the cycle's distinguished points
+                        // this walk met before they were published
+                        while (e.cyclic && !zero(s)) {
+                            h = lookup(sink(r).entries, q[predecessor(s)]);
+                            if (h == 0 || !source(h).cyclic) break;
+                            s = predecessor(s);
+                            e = source(h);
+                        }
+                    }
+                }
+                if (found && !e.cyclic) {
+                    t = triple<N, N, T>(i + e.m, e.c, e.y);
+                    break;
+                }
+                if (found) {
+                    N j = (s == size(q)) ? i : iq[s];
+                    N m = distinguished_connection(x, q, iq, s, j, e, f, t.m2);
+                    t = triple<N, N, T>(m, e.c, t.m2);
+                    break;
+                }
+            }
+            pointer(S) h = lookup(seen, y);
+            if (h != 0) {      // $y = q_u$ and the cycle size is $i - iq_u$
+                u = source(h);
+                S b = predecessor(size(q));
+                E e(true, i - iq[b], predecessor(i - iq[u]), q[b]);
+                N m = distinguished_connection(x, q, iq, u, iq[u], e, f, t.m2);
+                t = triple<N, N, T>(m, e.c, t.m2);
+                cycle_found = true;
+                break;
+            }
+            insert(seen, y, size(q));
+            push(q, y);
+            push(iq, i);
+            w = y;
+            iw = i;
+            lim = N(1);
+        } else if (y == w && iw != i) {
+            // The cycle has size $i - iw$ and no distinguished point, so the
+            // last distinguished point is not on the cycle; move $y$ to the
+            // cycle point whose index is congruent to that of the anchor
+            N c = i - iw;
+            T a = x;
+            N j(0);
+            if (!empty(q)) {
+                a = q[predecessor(size(q))];
+                j = iq[predecessor(size(iq))];
+            }
+            N e = (i - j) % c;
+            if (!zero(e)) y = power_unary(y, c - e, f);
+            pair<N, T> v = convergent_point_distance(a, N(0), y, N(0), f);
+            t = triple<N, N, T>(j + v.m0, predecessor(c), v.m1);
+            break;
+        } else if (i - iw == lim) {
+            w = y;
+            iw = i;
+            lim = twice(lim);
+        }
+        y = f(y);
+        i = successor(i);
+    }
+    if (r == 0) return t;
+    std::lock_guard<std::mutex> lock(sink(r).mutex);
+    for (S v(0); v < size(q) && iq[v] < t.m0; v = successor(v))
+        insert(sink(r).entries, q[v], E(false, t.m0 - iq[v], t.m1, t.m2));
+    if (cycle_found) {
+        S b = predecessor(size(q));
+        insert(sink(r).entries, q[u], E(true, i - iq[b], t.m1, q[b]));
+        for (S v = successor(u); v < size(q); v = successor(v))
+            insert(sink(r).entries, q[v],
+                   E(true, iq[v] - iq[predecessor(v)], t.m1, q[predecessor(v)]));
+    }
+    return t;
+}
+
+template<typename F, typename P>
+    requires(Transformation(F) && Integer(Domain(F)) &&
+        UnaryPredicate(P) && Domain(F) == Domain(P))
+triple<DistanceType(F), DistanceType(F), Domain(F)>
+orbit_structure_distinguished(const Domain(F)& x, F f, P p, int k)
+{
+    // Precondition: $p(x) \Leftrightarrow \text{$f(x)$ is defined}$
+    pointer(distinguished_point_registry<F>) r = 0;
+    return orbit_structure_distinguished(x, f, p, k, r);
+    // Postcondition: same as $\func{orbit\_structure}(x, f, p)$
+}
+
+template<typename I, typename O, typename F, typename P>
+    requires(Readable(I) && Iterator(I) && Writable(O) && Iterator(O) &&
+        Transformation(F) && Domain(F) == ValueType(I) &&
+        UnaryPredicate(P) && Domain(F) == Domain(P))
+struct orbit_structure_worker
+{
+    typedef DistanceType(I) N;
+    I f_x;
+    N n;
+    O f_o;
+    N first;
+    N stride;
+    F f;
+    P p;
+    int k;
+    pointer(distinguished_point_registry<F>) r;
+    orbit_structure_worker(I f_x, N n, O f_o, N first, N stride, F f, P p, int k,
+        pointer(distinguished_point_registry<F>) r)
+        : f_x(f_x), n(n), f_o(f_o), first(first), stride(stride),
+          f(f), p(p), k(k), r(r) { }
+    void operator()()
+    {
+        for (N i = first; i < n; i = i + stride)
+            sink(f_o + i) =
+                orbit_structure_distinguished(source(f_x + i), f, p, k, r);
+    }
+};
+
+template<typename I, typename O, typename F, typename P>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        Writable(O) && RandomAccessIterator(O) &&
+        Transformation(F) && Domain(F) == ValueType(I) &&
+        UnaryPredicate(P) && Domain(F) == Domain(P) &&
+        ValueType(O) ==
+            triple<DistanceType(F), DistanceType(F), Domain(F)>)
+O orbit_structure_distinguished_n(I f_x, DistanceType(I) n, O f_o,
+                                  F f, P p, int k, int threads)
+{
+    // Precondition: $\func{readable\_weak\_range}(f_x, n) \wedge
+    //                \func{writable\_weak\_range}(f_o, n) \wedge threads > 0$
+    // Precondition: $f$ and $p$ may be called concurrently
+    // Postcondition: $\func{source}(f_o + i) =
+    //                 \func{orbit\_structure}(\func{source}(f_x + i), f, p)$
+    // Walks from different starting points run on $threads$ threads and
+    // share a registry of distinguished points, so a walk stops as soon as
+    // it merges into an orbit that another walk has already analyzed.
+    // A single orbit is followed by one thread; see
+    // $\func{orbit\_structure\_parallel}$ for a composable transformation
+    typedef DistanceType(I) N;
+    typedef orbit_structure_worker<I, O, F, P> W;
+    distinguished_point_registry<F> r;
+    if (threads == 1) {
+        W(f_x, n, f_o, N(0), N(1), f, p, k, &r)();
+        return f_o + n;
+    }
+    pointer(std::thread) t = new std::thread[threads];
+    for (int u = 0; u < threads; u = successor(u))
+        t[u] = std::thread(W(f_x, n, f_o, N(u), N(threads), f, p, k, &r));
+    for (int u = 0; u < threads; u = successor(u))
+        t[u].join();
+    delete[] t;
+    return f_o + n;
+}
+
+
+// Parallel analysis of a single orbit
+
+// The points of one orbit are a chain, but for a composable
+// transformation $f^i(x)$ takes $O(\log i)$ compositions, so each thread
+// can start a segment far ahead and walk it independently. A round gives
+// each of $threads$ threads the next segment of the indices, and a shared
+// registry keeps the least index at which each distinguished point was
+// seen. A point seen at two indices, or a segment that returns to its own
+// start, gives a multiple of the cycle size; once every index up to that
+// round is covered, two consecutive visits of some cycle point have been
+// seen, so the least such multiple is the cycle size $c$. The tail is the
+// least $h$ with $f^h(x) = f^{h+c}(x)$, found by
+// $\func{convergent\_point\_distance}$. Segments grow by $2^{k+6}$ each
+// round, so a cycle without distinguished points is still found once a
+// segment is longer than it
+
+template<typename F>
+    requires(Transformation(F) && Integer(Domain(F)))
+struct orbit_segment_registry
+{
+    // Shared by the segments of one orbit; all accesses hold $mutex$
+    hash_table< Domain(F), DistanceType(F) > first; // least index seen
+    DistanceType(F) gap;       // least multiple of the cycle size, or 0
+    std::mutex mutex;
+    orbit_segment_registry() : gap(0) { }
+};
+
+template<typename F>
+    requires(Transformation(F) && Integer(Domain(F)))
+void record_gap(orbit_segment_registry<F>& r, DistanceType(F) g)
+{
+    // Precondition: $r.mutex$ is held
+    if (zero(r.gap) || g < r.gap) r.gap = g;
+}
+
+template<typename F>
+    requires(Transformation(F) && Integer(Domain(F)))
+struct orbit_segment_worker
+{
+    // Walks $f^i(x_0), \ldots, f^{i+n-1}(x_0)$ from $x = f^i(x_0)$
+    typedef Domain(F) T;
+    typedef DistanceType(F) N;
+    T x;
+    N i;
+    N n;
+    F f;
+    int k;
+    pointer(orbit_segment_registry<F>) r;
+    orbit_segment_worker(const T& x, N i, N n, F f, int k,
+                         pointer(orbit_segment_registry<F>) r)
+        : x(x), i(i), n(n), f(f), k(k), r(r) { }
+    void operator()()
+    {
+        distinguished_point<T> d(k);
+        T y = x;
+        N j(0);
+        while (j < n) {        // $y = f^j(x)$
+            if (d(y)) {
+                N iy = i + j;
+                std::lock_guard<std::mutex> lock(sink(r).mutex);
+                pointer(N) h = lookup(sink(r).first, y);
+                if (h == 0) {
+                    insert(sink(r).first, y, iy);
+                } else if (iy < source(h)) {
+                    record_gap(sink(r), source(h) - iy);
+                    sink(h) = iy;
+                } else {
+                    record_gap(sink(r), iy - source(h));
+                }
+            }
+            y = f(y);
+            j = successor(j);
+            if (y == x) {      // $x$ is on a cycle of size $j$
+                std::lock_guard<std::mutex> lock(sink(r).mutex);
+                record_gap(sink(r), j);
+                return;
+            }
+        }
+    }
+};
+
+template<typename F>
+    requires(Transformation(F) && Integer(Domain(F)))
+triple<DistanceType(F), DistanceType(F), Domain(F)>
+orbit_structure_parallel(const Domain(F)& x, F f, int k, int threads)
+{
+    // Precondition: $\func{TransformationConcept}(F) =
+    //                \type{composable\_transformation\_tag}$
+    // Precondition: the orbit of $x$ under $f$ is not terminating
+    // Precondition: $k \geq 0 \wedge 2^{k+6}$ is representable in
+    //               $\func{DistanceType}(F) \wedge threads > 0$
+    // Precondition: $f$ may be called concurrently
+    // Postcondition: same as $\func{orbit\_structure\_nonterminating\_orbit}(x, f)$
+    typedef Domain(F) T;
+    typedef DistanceType(F) N;
+    typedef orbit_segment_worker<F> W;
+    orbit_segment_registry<F> r;
+    N l = N(64) << k;          // growth of the segments per round
+    N n = l;                   // length of the segments of this round
+    N i(0);                    // indices $[0, i)$ are covered
+    T y = x;                   // $y = f^i(x)$
+    pointer(std::thread) t = new std::thread[threads];
+    while (zero(r.gap)) {
+        F g = power(f, n, composition<F>());
+        if (threads == 1) {
+            W(y, i, n, f, k, &r)();
+            y = g(y);
+            i = i + n;
+        } else {
+            for (int u = 0; u < threads; u = successor(u)) {
+                t[u] = std::thread(W(y, i, n, f, k, &r));
+                y = g(y);
+                i = i + n;
+            }
+            for (int u = 0; u < threads; u = successor(u))
+                t[u].join();
+        }
+        n = n + l;
+    }
+    delete[] t;
+    N c = r.gap;
+    pair<N, T> h = convergent_point_distance(
+        x, power_unary(x, c, f), f, composable_transformation_tag());
+    return triple<N, N, T>(h.m0, predecessor(c), h.m1);
+}
+
+
+// Decomposition of a finite transformation given by a table
+
+// The orbits of all the points of a table share their tails and cycles,
+// so they can be analyzed together in one pass visiting every point once.
+// Each walk follows unvisited points, marking them in a one byte colour
+// array, until it reaches a point outside the table, a point already
+// analyzed, or a point of its own path; the results are then filled in
+// backwards along the path.
+
+const unsigned char table_unvisited = 0;
+const unsigned char table_done = 1;
+// $table\_done + 1 + u$ marks the path of walker $u$
+
+template<typename I, typename O>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        ValueType(I) == DistanceType(I) &&
+        Writable(O) && RandomAccessIterator(O) &&
+        ValueType(O) == triple<DistanceType(I), DistanceType(I), DistanceType(I)>)
+struct table_orbit_structure_worker
+{
+    typedef DistanceType(I) N;
+    typedef triple<N, N, N> T;
+    I f_t;
+    N n;
+    O f_o;
+    pointer(std::atomic<unsigned char>) colour;
+    N lo;
+    N hi;
+    unsigned char mine;
+    pointer(array<N>) deferred;
+    table_orbit_structure_worker(I f_t, N n, O f_o,
+                                 pointer(std::atomic<unsigned char>) colour,
+                                 N lo, N hi, int u, pointer(array<N>) deferred)
+        : f_t(f_t), n(n), f_o(f_o), colour(colour), lo(lo), hi(hi),
+          mine((unsigned char)(table_done + 1 + u)), deferred(deferred) { }
+    void finish(N x, const T& t)
+    {
+        sink(f_o + x) = t;
+        colour[x].store(table_done, std::memory_order_release);
+    }
+    bool walk(N x, array<N>& path)
+    {
+        // Postcondition: returns false, leaving the points unvisited, if the
+        // walk from $x$ reached the path of another walker
+        N v = x;
+        while (true) {
+            if (v < N(0) || !(v < n)) {
+                N k = size(path);
+                while (!zero(k)) {
+                    k = predecessor(k);
+                    finish(path[k], T(size(path) - k, N(0), v));
+                }
+                break;
+            }
+            unsigned char c = colour[v].load(std::memory_order_acquire);
+            if (c == table_unvisited) {
+                if (!colour[v].compare_exchange_strong(c, mine)) continue;
+                sink(f_o + v).m0 = size(path); // position on the path
+                push(path, v);
+                v = source(f_t + v);
+            } else if (c == table_done) {
+                T t = source(f_o + v);
+                N k = size(path);
+                while (!zero(k)) {
+                    k = predecessor(k);
+                    finish(path[k], T(t.m0 + (size(path) - k), t.m1, t.m2));
+                }
+                break;
+            } else if (c == mine) {
+                N j = source(f_o + v).m0;
+                N c1 = predecessor(size(path) - j);
+                for (N k = j; k < size(path); k = successor(k))
+                    finish(path[k], T(N(0), c1, path[k]));
+                N k = j;
+                while (!zero(k)) {
+                    k = predecessor(k);
+                    finish(path[k], T(j - k, c1, v));
+                }
+                break;
+            } else {
+                for (N k(0); k < size(path); k = successor(k))
+                    colour[path[k]].store(table_unvisited, std::memory_order_release);
+                erase_all(path);
+                return false;
+            }
+        }
+        erase_all(path);
+        return true;
+    }
+    void operator()()
+    {
+        array<N> path;
+        for (N x = lo; x < hi; x = successor(x))
+            if (colour[x].load(std::memory_order_acquire) == table_unvisited &&
+                !walk(x, path))
+                push(sink(deferred), x);
+    }
+};
+
+template<typename I, typename O>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        ValueType(I) == DistanceType(I) &&
+        Writable(O) && RandomAccessIterator(O) &&
+        ValueType(O) == triple<DistanceType(I), DistanceType(I), DistanceType(I)>)
+O orbit_structures_table(I f_t, DistanceType(I) n, O f_o, int threads)
+{
+    // Precondition: $\func{readable\_weak\_range}(f_t, n) \wedge
+    //                \func{writable\_weak\_range}(f_o, n) \wedge 0 < threads < 255$
+    // Postcondition: $\func{source}(f_o + x) = \func{orbit\_structure}(x, f, p)$
+    // for $0 \leq x < n$, where $f(x) = \func{source}(f_t + x)$ and
+    // $p(x) \Leftrightarrow 0 \leq x < n$
+    // Each thread starts walks from its own block of the table; a walk that
+    // runs into the path of another thread is abandoned and redone after
+    // all the threads have finished.
+    typedef DistanceType(I) N;
+    typedef table_orbit_structure_worker<I, O> W;
+    pointer(std::atomic<unsigned char>) colour =
+        new std::atomic<unsigned char>[n];
+    for (N x(0); x < n; x = successor(x))
+        colour[x].store(table_unvisited, std::memory_order_relaxed);
+    array< array<N> > deferred(threads, threads, array<N>());
+    if (threads == 1) {
+        W(f_t, n, f_o, colour, N(0), n, 0, &deferred[0])();
+    } else {
+        pointer(std::thread) t = new std::thread[threads];
+        for (int u = 0; u < threads; u = successor(u))
+            t[u] = std::thread(W(f_t, n, f_o, colour,
+                                 (n / N(threads)) * N(u),
+                                 u == predecessor(threads) ? n :
+                                     (n / N(threads)) * N(successor(u)),
+                                 u, &deferred[u]));
+        for (int u = 0; u < threads; u = successor(u))
+            t[u].join();
+        delete[] t;
+        for (int u = 0; u < threads; u = successor(u)) {
+            W w(f_t, n, f_o, colour, N(0), N(0), 0, &deferred[u]);
+            array<N> path;
+            for (N k(0); k < size(deferred[u]); k = successor(k)) {
+                N x = deferred[u][k];
+                if (colour[x].load(std::memory_order_acquire) == table_unvisited)
+                    w.walk(x, path);
+            }
+        }
+    }
+    delete[] colour;
+    return f_o + n;
+}
+
+template<typename I, typename O>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        ValueType(I) == DistanceType(I) &&
+        Writable(O) && RandomAccessIterator(O) &&
+        ValueType(O) == triple<DistanceType(I), DistanceType(I), DistanceType(I)>)
+O orbit_structures_table(I f_t, DistanceType(I) n, O f_o)
+{
+    // Precondition: $\func{readable\_weak\_range}(f_t, n) \wedge
+    //                \func{writable\_weak\_range}(f_o, n)$
+    return orbit_structures_table(f_t, n, f_o, 1);
+}
+
+
+// Lockstep analysis of many orbits of an affine transformation
+
+// The orbits of $k$ starting points advance together, one lane each, so
+// that every step applies the same arithmetic to $k$ independent values.
+// The remainder by the common modulus is computed from a floating point
+// reciprocal and corrected without branches, which lets the compiler
+// vectorize the step over the lanes.
+
+template<typename T>
+    requires(Integer(T))
+struct affine_lanes_step
+{
+    long long a;
+    long long b;
+    long long m;
+    double r;                  // $1 / m$
+    bool narrow;               // $(m - 1)^2 + m$ fits in \type{long long}
+    affine_transformation<T> f;
+    affine_lanes_step(const affine_transformation<T>& f)
+        : a(f.a), b(f.b), m(f.m), r(1.0 / double(f.m)),
+          narrow((long long)(f.m) <= 3037000499ll), f(f) { }
+    long long reduce(long long t)
+    {
+        // Precondition: $0 \leq t < m^2$
+        long long z = t - (long long)(double(t) * r) * m; // $-m \leq z < 2m$
+        z = z + (m & -(long long)(z < 0));
+        return z - (m & -(long long)(!(z < m)));
+    }
+    T operator()(T x)
+    {
+        if (!narrow) return f(x);
+        return T(reduce(a * (long long)(x) + b));
+    }
+};
+
+template<int k, typename T>
+    requires(Integer(T))
+void affine_lanes(affine_lanes_step<T>& f, array_k<k, T>& x, array_k<k, T>& y)
+{
+    if (!f.narrow) {
+        for (int i = 0; i < k; ++i) y[i] = f.f(x[i]);
+        return;
+    }
+    for (int i = 0; i < k; ++i) // no branches: vectorizable
+        y[i] = T(f.reduce(f.a * (long long)(x[i]) + f.b));
+}
+
+template<int k, typename T, typename I, typename O>
+    requires(Integer(T) && Readable(I) && Iterator(I) && ValueType(I) == T &&
+        Writable(O) && RandomAccessIterator(O) &&
+        ValueType(O) == triple<DistanceType(T), DistanceType(T), T>)
+O orbit_structure_lanes(I f_x, DistanceType(I) n, O f_o,
+                        const affine_transformation<T>& f)
+{
+    // Precondition: $\func{readable\_weak\_range}(f_x, n) \wedge
+    //                \func{writable\_weak\_range}(f_o, n)$
+    // Precondition: $(\forall i < n)\,0 \leq \func{source}(f_x + i) < f.m$
+    // Postcondition: $\func{source}(f_o + i) =
+    //     \func{orbit\_structure\_nonterminating\_orbit}(\func{source}(f_x + i), f)$
+    // Each lane runs the three phases of
+    // $\func{orbit\_structure\_nonterminating\_orbit}$: $u$ and $v$ are the
+    // slow and fast points, then the two points converging to the
+    // connection point, then the point walking around the cycle.
+    // A finished lane takes the next starting point; once there are none
+    // left, it is masked off until the other lanes finish.
+    typedef DistanceType(T) N;
+    typedef DistanceType(I) D;
+    const int collision = 0, connection = 1, cycle = 2, done = 3;
+    affine_lanes_step<T> g(f);
+    array_k<k, T> x0, u, v, fu, fv, ffv;
+    array_k<k, N> c, h;
+    array_k<k, D> j;           // index of the starting point of each lane
+    array_k<k, int> phase;
+    D next(0);
+    int active = 0;
+    for (int i = 0; i < k; ++i) {
+        x0[i] = u[i] = v[i] = T(0);
+        c[i] = h[i] = N(0);
+        phase[i] = done;
+        if (next < n) {
+            j[i] = next;
+            x0[i] = u[i] = source(f_x + next);
+            v[i] = g(u[i]);
+            phase[i] = collision;
+            next = successor(next);
+            active = successor(active);
+        }
+    }
+    while (!zero(active)) {
+        affine_lanes(g, u, fu);
+        affine_lanes(g, v, fv);
+        affine_lanes(g, fv, ffv);
+        for (int i = 0; i < k; ++i) {
+            if (phase[i] == collision) {
+                if (u[i] == v[i]) {        // $v$ is the collision point
+                    u[i] = x0[i];
+                    v[i] = fv[i];
+                    c[i] = N(0);
+                    phase[i] = connection;
+                } else {
+                    u[i] = fu[i];
+                    v[i] = ffv[i];
+                }
+            } else if (phase[i] == connection) {
+                if (u[i] == v[i]) {        // $u$ is the connection point
+                    h[i] = c[i];
+                    u[i] = fu[i];
+                    c[i] = N(0);
+                    phase[i] = cycle;
+                } else {
+                    u[i] = fu[i];
+                    v[i] = fv[i];
+                    c[i] = successor(c[i]);
+                }
+            } else if (phase[i] == cycle) {
+                if (u[i] == v[i]) {
+                    sink(f_o + j[i]) = triple<N, N, T>(h[i], c[i], v[i]);
+                    if (next < n) {
+                        j[i] = next;
+                        x0[i] = u[i] = source(f_x + next);
+                        v[i] = g(u[i]);
+                        phase[i] = collision;
+                        next = successor(next);
+                    } else {
+                        phase[i] = done;
+                        active = predecessor(active);
+                    }
+                } else {
+                    u[i] = fu[i];
+                    c[i] = successor(c[i]);
+                }
+            }
+        }
+    }
+    return f_o + n;
+}
+
+
+// Checkpointed orbit engines
+
+// These engines save their state to a file every $interval$ iterations and,
+// when called again with the same arguments, resume from the saved state
+// instead of starting over. A record is 8 header bytes followed by the key
+// of the transformation, the two arguments, the two points of the state and
+// the iteration count, in the native representation. It is written to a
+// temporary file that then replaces the previous record, so an
+// interruption leaves either the old or the new record; where $\func{rename}$
+// cannot replace a file (Windows) the old record is removed first, and an
+// interruption between the two steps leaves no record. The final record
+// marks the result, so a repeated call returns at once; the caller removes
+// the file when it is no longer needed.
+// A record is used only when its key equals $\func{transformation\_key}(f)$.
+// A transformation without its own $\func{transformation\_key}$ has the
+// key $\func{no\_transformation\_key}$, which cannot tell it from another
+// transformation, so it is neither saved nor resumed.
+// The values are saved in their native representation, which is their
+// value only for types that own no storage; $\func{native\_checkpoint}$
+// admits the built-in integers, and a checkpoint of any other type does
+// not compile until the type is admitted or given its own overloads of
+// $\func{read\_checkpoint\_value}$ and $\func{write\_checkpoint\_value}$
+
+unsigned long long key_combine(unsigned long long k, unsigned long long x)
+{
+    // One FNV-1a step on a whole word
+    return (k ^ x) * 1099511628211ull;
+}
+
+const unsigned long long key_basis = 14695981039346656037ull;
+
+const unsigned long long no_transformation_key = 0ull;
+
+template<typename F>
+    requires(Transformation(F))
+unsigned long long transformation_key(const F&)
+{
+    return no_transformation_key;
+}
+
+template<typename I>
+    requires(Integer(I))
+unsigned long long transformation_key(const affine_transformation<I>& f)
+{
+    return key_combine(key_combine(key_combine(key_basis,
+        (unsigned long long)f.a), (unsigned long long)f.b), (unsigned long long)f.m);
+}
+
+template<typename T>
+struct native_checkpoint; // $\func{type}$ is $T$ for the admitted types
+
+template<> struct native_checkpoint<int> { typedef int type; };
+template<> struct native_checkpoint<unsigned int> { typedef unsigned int type; };
+template<> struct native_checkpoint<long> { typedef long type; };
+template<> struct native_checkpoint<unsigned long> { typedef unsigned long type; };
+template<> struct native_checkpoint<long long> { typedef long long type; };
+template<> struct native_checkpoint<unsigned long long>
+{
+    typedef unsigned long long type;
+};
+
+template<typename T>
+    requires(Integer(T))
+bool read_checkpoint_value(pointer(FILE) s, T& x)
+{
+    typedef typename native_checkpoint<T>::type U;
+    return fread(&x, sizeof(U), 1, s) == 1;
+}
+
+template<typename T>
+    requires(Integer(T))
+bool write_checkpoint_value(pointer(FILE) s, const T& x)
+{
+    typedef typename native_checkpoint<T>::type U;
+    return fwrite(&x, sizeof(U), 1, s) == 1;
+}
+
+template<typename T, typename N>
+    requires(Regular(T) && Integer(N))
+struct orbit_checkpoint
+{
+    unsigned char engine;
+    bool complete;
+    unsigned long long key;    // of the transformation
+    T x0;                      // arguments
+    T x1;
+    T u;                       // state
+    T v;
+    N n;                       // iterations completed
+    orbit_checkpoint() { }
+    orbit_checkpoint(unsigned char engine, unsigned long long key,
+                     const T& x0, const T& x1, const T& u, const T& v, N n)
+        : engine(engine), complete(false), key(key),
+          x0(x0), x1(x1), u(u), v(v), n(n) { }
+};
+
+const unsigned char checkpoint_collision_point = 1;
+const unsigned char checkpoint_convergent_point = 2;
+const unsigned char checkpoint_distance = 3;
+
+template<typename T, typename N>
+    requires(Integer(T) && Integer(N))
+bool read_checkpoint(const pointer(char) file, unsigned char engine,
+                     unsigned long long key, const T& x0, const T& x1,
+                     orbit_checkpoint<T, N>& c)
+{
+    // Postcondition: returns false unless $file$ holds a record of $engine$
+    // for the transformation $key$ and the arguments $x0$ and $x1$
+    if (key == no_transformation_key) return false;
+    pointer(FILE) s = fopen(file, "rb");
+    if (s == 0) return false;
+    unsigned char h[8];
+    bool ok = fread(h, 1, 8, s) == 8 &&
+              h[0] == 'E' && h[1] == 'O' && h[2] == 'P' && h[3] == 'C' &&
+              h[4] == sizeof(T) && h[5] == sizeof(N) && h[6] == engine &&
+              read_checkpoint_value(s, c.key) &&
+              read_checkpoint_value(s, c.x0) &&
+              read_checkpoint_value(s, c.x1) &&
+              read_checkpoint_value(s, c.u) &&
+              read_checkpoint_value(s, c.v) &&
+              read_checkpoint_value(s, c.n) &&
+              c.key == key && c.x0 == x0 && c.x1 == x1;
+    fclose(s);
+    c.engine = engine;
+    c.complete = ok && h[7] != 0;
+    return ok;
+}
+
+template<typename T, typename N>
+    requires(Integer(T) && Integer(N))
+void write_checkpoint(const pointer(char) file, const orbit_checkpoint<T, N>& c)
+{
+    if (c.key == no_transformation_key) return;
+    char t[FILENAME_MAX];
+    snprintf(t, FILENAME_MAX, "%s.tmp", file);
+    pointer(FILE) s = fopen(t, "wb");
+    if (s == 0) return;        // checkpointing is best effort
+    unsigned char h[8] = { 'E', 'O', 'P', 'C', (unsigned char)sizeof(T),
+                           (unsigned char)sizeof(N), c.engine, c.complete };
+    bool ok = fwrite(h, 1, 8, s) == 8 &&
+              write_checkpoint_value(s, c.key) &&
+              write_checkpoint_value(s, c.x0) &&
+              write_checkpoint_value(s, c.x1) &&
+              write_checkpoint_value(s, c.u) &&
+              write_checkpoint_value(s, c.v) &&
+              write_checkpoint_value(s, c.n);
+    ok = fclose(s) == 0 && ok;
+    if (ok && rename(t, file) != 0) {
+        remove(file);
+        ok = rename(t, file) == 0;
+    }
+    if (!ok) remove(t);
+}
+
+template<typename F, typename P>
+    requires(Transformation(F) && UnaryPredicate(P) &&
+        Domain(F) == Domain(P))
+Domain(F) collision_point_checkpointed(const Domain(F)& x, F f, P p,
+                                       const pointer(char) file,
+                                       DistanceType(F) interval)
+{
+    // Precondition: $p(x) \Leftrightarrow \text{$f(x)$ is defined} \wedge interval > 0$
+    // Postcondition: same as $\func{collision\_point}(x, f, p)$
+    typedef Domain(F) T;
+    typedef DistanceType(F) N;
+    typedef orbit_checkpoint<T, N> C;
+    if (!p(x)) return x;
+    C c;                       // $u = f^n(x) \wedge v = f^{2 n + 1}(x)$
+    unsigned long long k = transformation_key(f);
+    if (!read_checkpoint(file, checkpoint_collision_point, k, x, x, c))
+        c = C(checkpoint_collision_point, k, x, x, x, f(x), N(0));
+    if (c.complete) return c.v;
+    while (c.v != c.u) {
+        c.u = f(c.u);
+        if (!p(c.v)) break;
+        c.v = f(c.v);
+        if (!p(c.v)) break;
+        c.v = f(c.v);
+        c.n = successor(c.n);
+        if (zero(c.n % interval)) write_checkpoint(file, c);
+    }
+    c.complete = true;
+    write_checkpoint(file, c);
+    return c.v;
+}
+
+template<typename F>
+    requires(Transformation(F))
+Domain(F) convergent_point_checkpointed(const Domain(F)& x0,
+                                        const Domain(F)& x1, F f,
+                                        const pointer(char) file,
+                                        DistanceType(F) interval)
+{
+    // Precondition: $(\exists n \in \func{DistanceType}(F))\,n \geq 0 \wedge f^n(x0) = f^n(x1)$
+    // Precondition: $interval > 0$
+    // Postcondition: same as $\func{convergent\_point}(x0, x1, f)$
+    typedef Domain(F) T;
+    typedef DistanceType(F) N;
+    typedef orbit_checkpoint<T, N> C;
+    C c;                       // $u = f^n(x0) \wedge v = f^n(x1)$
+    unsigned long long k = transformation_key(f);
+    if (!read_checkpoint(file, checkpoint_convergent_point, k, x0, x1, c))
+        c = C(checkpoint_convergent_point, k, x0, x1, x0, x1, N(0));
+    if (c.complete) return c.u;
+    while (c.u != c.v) {
+        c.u = f(c.u);
+        c.v = f(c.v);
+        c.n = successor(c.n);
+        if (zero(c.n % interval)) write_checkpoint(file, c);
+    }
+    c.complete = true;
+    write_checkpoint(file, c);
+    return c.u;
+}
+
+template<typename F>
+    requires(Transformation(F))
+DistanceType(F) distance_checkpointed(const Domain(F)& x, const Domain(F)& y,
+                                      F f, const pointer(char) file,
+                                      DistanceType(F) interval)
+{
+    // Precondition: $y$ is reachable from $x$ under $f \wedge interval > 0$
+    // Postcondition: same as $\func{distance}(x, y, f)$
+    typedef Domain(F) T;
+    typedef DistanceType(F) N;
+    typedef orbit_checkpoint<T, N> C;
+    C c;                       // $u = f^n(x)$
+    unsigned long long k = transformation_key(f);
+    if (!read_checkpoint(file, checkpoint_distance, k, x, y, c))
+        c = C(checkpoint_distance, k, x, y, x, y, N(0));
+    if (c.complete) return c.n;
+    while (c.u != y) {
+        c.u = f(c.u);
+        c.n = successor(c.n);
+        if (zero(c.n % interval)) write_checkpoint(file, c);
+    }
+    c.complete = true;
+    write_checkpoint(file, c);
+    return c.n;
+}
+
+struct orbit_checkpoint_files
+{
+    // $\func{orbit\_structure\_checkpointed}$ keeps one file per phase
+    char name[4][FILENAME_MAX];
+    orbit_checkpoint_files(const pointer(char) prefix)
+    {
+        for (int i = 0; i < 4; ++i)
+            snprintf(name[i], FILENAME_MAX, "%s.%d", prefix, successor(i));
+    }
+};
+
+template<typename F, typename P>
+    requires(Transformation(F) && UnaryPredicate(P) &&
+        Domain(F) == Domain(P))
+triple<DistanceType(F), DistanceType(F), Domain(F)>
+orbit_structure_checkpointed(const Domain(F)& x, F f, P p,
+                             const pointer(char) prefix,
+                             DistanceType(F) interval)
+{
+    // Precondition: $p(x) \Leftrightarrow \text{$f(x)$ is defined} \wedge interval > 0$
+    // Postcondition: same as $\func{orbit\_structure}(x, f, p)$
+    typedef DistanceType(F) N;
+    orbit_checkpoint_files c(prefix);
+    Domain(F) y = collision_point_checkpointed(x, f, p, c.name[0], interval);
+    if (p(y)) y = convergent_point_checkpointed(x, f(y), f, c.name[1], interval);
+    N m = distance_checkpointed(x, y, f, c.name[2], interval);
+    N n(0);
+    if (p(y)) n = distance_checkpointed(f(y), y, f, c.name[3], interval);
+    return triple<N, N, Domain(F)>(m, n, y);
+}
+
+void remove_orbit_checkpoints(const pointer(char) prefix)
+{
+    orbit_checkpoint_files c(prefix);
+    for (int i = 0; i < 4; ++i) remove(c.name[i]);
+}
+
+#endif // EOP_ORBITS
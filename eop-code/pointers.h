@@ -107,5 +107,26 @@ struct iterator_concept<T*>
     typedef random_access_iterator_tag concept;
 };
 
+// Pointers to the arithmetic types for which the quantifiers of Chapter 6
+// have block-at-a-time versions
+
+template<>
+struct storage_concept<int*> { typedef contiguous_storage_tag concept; };
+
+template<>
+struct storage_concept<const int*> { typedef contiguous_storage_tag concept; };
+
+template<>
+struct storage_concept<char*> { typedef contiguous_storage_tag concept; };
+
+template<>
+struct storage_concept<const char*> { typedef contiguous_storage_tag concept; };
+
+template<>
+struct storage_concept<double*> { typedef contiguous_storage_tag concept; };
+
+template<>
+struct storage_concept<const double*> { typedef contiguous_storage_tag concept; };
+
 #endif // EOP_POINTERS
 
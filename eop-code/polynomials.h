@@ -0,0 +1,1151 @@
+// polynomials.h
+
+// Copyright (c) 2009 Alexander Stepanov and Paul McJones
+//
+// Permission to use, copy, modify, distribute and sell this software
+// and its documentation for any purpose is hereby granted without
+// fee, provided that the above copyright notice appear in all copies
+// and that both that copyright notice and this permission notice
+// appear in supporting documentation. The authors make no
+// representations about the suitability of this software for any
+// purpose. It is provided "as is" without express or implied
+// warranty.
+
+
+// Polynomials extending Chapter 5 of
+// Elements of Programming
+// by Alexander Stepanov and Paul McJones
+// Addison-Wesley Professional, 2009
+
+
+#ifndef EOP_POLYNOMIALS
+#define EOP_POLYNOMIALS
+
+
+#include "intrinsics.h"
+#include "type_functions.h"
+#include "eop.h"
+#include "euclidean.h"
+#include "print.h"
+
+
+// Integers modulo $p$
+
+// type modular_integer
+// model CommutativeRing(modular_integer)
+
+// The residues modulo $p < 2^{32}$, represented by $0 \leq x < p$; a field
+// when $p$ is prime. A prime $p = c 2^k + 1$ has primitive $2^k$-th roots
+// of unity, so products of polynomials over it can use the
+// number-theoretic transform.
+
+template<unsigned p>
+struct modular_integer
+{
+    unsigned x;                // $0 \leq x < p$
+    modular_integer() { }
+    modular_integer(long long a)
+    {
+        long long r = a % (long long)(p);
+        x = unsigned(r < 0 ? r + (long long)(p) : r);
+    }
+};
+
+template<unsigned p>
+modular_integer<p> operator+(const modular_integer<p>& a,
+                             const modular_integer<p>& b)
+{
+    modular_integer<p> c;
+    // Selects rather than branches: the comparisons are unpredictable
+    unsigned long long s = (unsigned long long)(a.x) + b.x;
+    c.x = unsigned(s - (s < p ? 0ull : (unsigned long long)(p)));
+    return c;
+}
+
+template<unsigned p>
+modular_integer<p> operator-(const modular_integer<p>& a)
+{
+    modular_integer<p> c;
+    c.x = a.x == 0u ? 0u : p - a.x;
+    return c;
+}
+
+template<unsigned p>
+modular_integer<p> operator-(const modular_integer<p>& a,
+                             const modular_integer<p>& b)
+{
+    modular_integer<p> c;
+    c.x = a.x - b.x + (a.x < b.x ? p : 0u);
+    return c;
+}
+
+template<unsigned p>
+modular_integer<p> operator*(const modular_integer<p>& a,
+                             const modular_integer<p>& b)
+{
+    // $p$ is a constant, so the remainder is a multiply and shift
+    modular_integer<p> c;
+    c.x = unsigned((unsigned long long)(a.x) * b.x % p);
+    return c;
+}
+
+template<unsigned p>
+modular_integer<p> multiplicative_inverse(const modular_integer<p>& a)
+{
+    // Precondition: $\gcd(a, p) = 1$
+    return modular_integer<p>(multiplicative_inverse_modulo<long long>(
+        (long long)(a.x), (long long)(p)));
+}
+
+template<unsigned p>
+bool operator==(const modular_integer<p>& a, const modular_integer<p>& b)
+{
+    return a.x == b.x;
+}
+
+template<unsigned p>
+bool operator<(const modular_integer<p>& a, const modular_integer<p>& b)
+{
+    // An order on the representatives, for use with sorting
+    return a.x < b.x;
+}
+
+template<unsigned p>
+void print(const modular_integer<p>& a)
+{
+    print(a.x);
+}
+
+
+// Convolution
+
+// The coefficients of a product of polynomials are the convolution of
+// their coefficient sequences. These procedures take a sequence as a
+// pointer and a length and write the $n_f + n_g - 1$ terms of the
+// convolution to caller-provided storage, which must not overlap the
+// arguments.
+
+// Convolutions with a shorter sequence of at least this many terms use
+// Karatsuba's method
+const int polynomial_karatsuba_threshold = 32;
+
+// Convolutions over a suitable modular_integer with a shorter sequence of
+// at least this many terms use the number-theoretic transform
+const int polynomial_ntt_threshold = 64;
+
+template<typename T>
+    requires(Ring(T))
+void convolution_schoolbook(const pointer(T) f, int n_f,
+                            const pointer(T) g, int n_g, pointer(T) h)
+{
+    // Precondition: $n_f, n_g > 0$
+    for (int i = 0; i < n_f + n_g - 1; i = successor(i)) h[i] = T(0);
+    for (int i = 0; i < n_f; i = successor(i)) {
+        T x = f[i];
+        for (int j = 0; j < n_g; j = successor(j))
+            h[i + j] = h[i + j] + x * g[j];
+    }
+}
+
+template<typename T>
+    requires(Ring(T))
+void convolution_karatsuba(const pointer(T) f, int n_f,
+                           const pointer(T) g, int n_g, pointer(T) h)
+{
+    // Precondition: $n_f, n_g > 0$
+    if (n_f < n_g) {
+        convolution_karatsuba(g, n_g, f, n_f, h);
+        return;
+    }
+    if (n_g < polynomial_karatsuba_threshold) {
+        convolution_schoolbook(f, n_f, g, n_g, h);
+        return;
+    }
+    int k = (n_f + 1) / 2;
+    if (n_g <= k) {
+        // Unbalanced: convolve $g$ with slices of $f$ of length $n_g$
+        for (int i = 0; i < n_f + n_g - 1; i = successor(i)) h[i] = T(0);
+        array<T> t(2 * n_g - 1, 2 * n_g - 1, T(0));
+        for (int i = 0; i < n_f; i = i + n_g) {
+            int m = n_f - i < n_g ? n_f - i : n_g;
+            convolution_karatsuba(f + i, m, g, n_g, begin(t));
+            for (int j = 0; j < m + n_g - 1; j = successor(j))
+                h[i + j] = h[i + j] + t[j];
+        }
+        return;
+    }
+    // Karatsuba: with $f = f_1 x^k + f_0$ and $g = g_1 x^k + g_0$,
+    // $f g = z_2 x^{2k} + (z_1 - z_2 - z_0) x^k + z_0$ where
+    // $z_2 = f_1 g_1$, $z_0 = f_0 g_0$ and $z_1 = (f_1 + f_0)(g_1 + g_0)$
+    int l_f = n_f - k;         // $0 < l_g \leq l_f \leq k$
+    int l_g = n_g - k;
+    array<T> s(4 * k - 1, 4 * k - 1, T(0));
+    pointer(T) s_f = begin(s);
+    pointer(T) s_g = s_f + k;
+    pointer(T) z_1 = s_g + k;
+    for (int i = 0; i < k; i = successor(i)) {
+        s_f[i] = i < l_f ? f[i] + f[k + i] : f[i];
+        s_g[i] = i < l_g ? g[i] + g[k + i] : g[i];
+    }
+    convolution_karatsuba(f, k, g, k, h);                        // $z_0$
+    h[twice(k) - 1] = T(0);
+    convolution_karatsuba(f + k, l_f, g + k, l_g, h + twice(k)); // $z_2$
+    convolution_karatsuba(s_f, k, s_g, k, z_1);
+    for (int i = 0; i < twice(k) - 1; i = successor(i))
+        z_1[i] = z_1[i] - h[i];
+    for (int i = 0; i < l_f + l_g - 1; i = successor(i))
+        z_1[i] = z_1[i] - h[twice(k) + i];
+    for (int i = 0; i < twice(k) - 1; i = successor(i))
+        h[k + i] = h[k + i] + z_1[i];
+}
+
+template<typename T>
+    requires(Ring(T))
+void convolution(const pointer(T) f, int n_f,
+                 const pointer(T) g, int n_g, pointer(T) h)
+{
+    // Precondition: $n_f, n_g > 0$
+    convolution_karatsuba(f, n_f, g, n_g, h);
+}
+
+
+// Number-theoretic transform
+
+bool prime_trial_division(unsigned n)
+{
+    if (n < 2u) return false;
+    for (unsigned d = 2u; d <= n / d; d = successor(d))
+        if (n % d == 0u) return false;
+    return true;
+}
+
+template<unsigned p>
+int number_theoretic_transform_order()
+{
+    // Returns the largest $k$ for which modular_integer<p> has a
+    // primitive $2^k$-th root of unity, or 0 when $p$ is not prime
+    static const int k = prime_trial_division(p) && p > 2u ?
+        count_trailing_zeros(p - 1u) : 0;
+    return k;
+}
+
+template<unsigned p>
+modular_integer<p> root_of_unity(int k)
+{
+    // Precondition: $0 < k \leq \func{number\_theoretic\_transform\_order}<p>()$
+    // Postcondition: returns a primitive $2^k$-th root of unity
+    // For a quadratic nonresidue $z$, $z^{(p - 1) / 2} = -1$, so
+    // $z^{(p - 1) / 2^k}$ has order exactly $2^k$
+    typedef modular_integer<p> Z;
+    multiplies<Z> op;
+    Z z(2);
+    while (power(z, (p - 1u) / 2u, op) == Z(1)) z = z + Z(1);
+    return power(z, (p - 1u) >> k, op);
+}
+
+template<unsigned p>
+void number_theoretic_transform(pointer(modular_integer<p>) a, int n,
+                                modular_integer<p> w)
+{
+    // Precondition: $n = 2^k \wedge w$ is a primitive $n$-th root of unity
+    // Postcondition: $a'[j] = \sum_i a[i] w^{i j}$
+    typedef modular_integer<p> Z;
+    int j = 0;
+    for (int i = 1; i < n; i = successor(i)) {
+        int b = n >> 1;
+        while (j & b) { j = j ^ b; b = b >> 1; }
+        j = j ^ b;
+        if (i < j) swap(a[i], a[j]);
+    }
+    // $r[m, 2 m)$ holds the powers of a primitive $2 m$-th root of unity
+    array<Z> r(n, n, Z(1));
+    for (int m = n >> 1; m > 0; m = m >> 1) {
+        Z w_m = w;
+        for (int i = 1; i < n / twice(m); i = twice(i)) w_m = w_m * w_m;
+        for (int i = 1; i < m; i = successor(i))
+            r[m + i] = r[m + i - 1] * w_m;
+    }
+    for (int m = 1; m < n; m = twice(m)) {
+        for (int i = 0; i < n; i = i + twice(m)) {
+            for (int l = 0; l < m; l = successor(l)) {
+                Z u = a[i + l];
+                Z v = a[i + l + m] * r[m + l];
+                a[i + l] = u + v;
+                a[i + l + m] = u - v;
+            }
+        }
+    }
+}
+
+template<unsigned p>
+void convolution(const pointer(modular_integer<p>) f, int n_f,
+                 const pointer(modular_integer<p>) g, int n_g,
+                 pointer(modular_integer<p>) h)
+{
+    // Precondition: $n_f, n_g > 0$
+    typedef modular_integer<p> Z;
+    int n = n_f + n_g - 1;
+    int k = 0;
+    while ((1 << k) < n) k = successor(k);
+    if (min(n_f, n_g) < polynomial_ntt_threshold ||
+            number_theoretic_transform_order<p>() < k) {
+        convolution_karatsuba(f, n_f, g, n_g, h);
+        return;
+    }
+    array<Z> a(1 << k, 1 << k, Z(0));
+    array<Z> b(1 << k, 1 << k, Z(0));
+    for (int i = 0; i < n_f; i = successor(i)) a[i] = f[i];
+    for (int i = 0; i < n_g; i = successor(i)) b[i] = g[i];
+    Z w = root_of_unity<p>(k);
+    number_theoretic_transform(begin(a), 1 << k, w);
+    number_theoretic_transform(begin(b), 1 << k, w);
+    for (int i = 0; i < (1 << k); i = successor(i)) a[i] = a[i] * b[i];
+    // The inverse transform is the transform at $w^{-1}$, divided by $2^k$
+    number_theoretic_transform(begin(a), 1 << k, multiplicative_inverse(w));
+    Z u = multiplicative_inverse(Z((long long)(1) << k));
+    for (int i = 0; i < n; i = successor(i)) h[i] = a[i] * u;
+}
+
+
+// polynomial<T> is a type constructor; it models the following concept
+// sparse_polynomial<T>, below, is a sparse model.
+
+// PolynomialRing(T) equals by definition
+//     ValueType : Polynomial -> CommutativeSemiring
+//     IndexType : Polynomial -> Integer
+//  /\ degree : T -> IndexType(T)
+//  /\ coefficient : T x IndexType(T) -> ValueType(T)
+//  /\ lc : T > ValueType(T)
+//            a \mapsto coefficient(a, degree(a))
+//  /\ tc : T > ValueType(T)
+//            a \mapsto coefficient(a, 0)
+//  /\ indeterminate : -> T
+//  /\ evaluate : T x ValueType(T) -> ValueType(T)
+//  /\  : ValueType(T) x T -> T
+//  /\ + : T x T -> T
+//  /\  : T x T -> T
+//  /\ shift_left : T x Integer -> T
+//        (a, n) \mapsto power(indeterminate(), n, )  a
+//  /\  ...
+
+
+template<typename T>
+    requires(Ring(T))
+struct polynomial
+{
+    typedef int IndexType;
+    array<T> coeff;
+    // Invariant: degree(f) = size(f.coeff) - 1 /\
+    //            coefficient(f, i) = f.coeff[degree(f) - i]
+    polynomial() : coeff(IndexType(1), IndexType(1), T(0)) { }     // f(x) = 0
+    polynomial(T x_0) : coeff(IndexType(1), IndexType(1), x_0) { } // f(x) = x_0
+};
+
+template<typename T>
+    requires(Ring(T))
+struct value_type< polynomial<T> >
+{
+    typedef T type;
+};
+
+template<typename T>
+    requires(Ring(T))
+struct index_type;
+
+#define IndexType(T) typename index_type< T >::type
+
+template<typename T>
+    requires(Ring(T))
+struct index_type< polynomial<T> >
+{
+    typedef typename polynomial<T>::IndexType type;
+};
+
+template<typename T>
+    requires(Ring(T))
+IndexType(polynomial<T>) operator==(const polynomial<T>& f, const polynomial<T>& g)
+{
+    return f.coeff == g.coeff;
+}
+
+template<typename T>
+    requires(Ring(T))
+IndexType(polynomial<T>) operator<(const polynomial<T>& f, const polynomial<T>& g)
+{
+    return degree(f) < degree(g) ||
+          degree(g) == degree(f) && f.coeff < g.coeff;
+}
+
+template<typename T>
+    requires(Ring(T))
+IndexType(polynomial<T>) degree(const polynomial<T>& f)
+{
+    // ***** Should degree(polynomial<T>(0)) = -infinity ?????
+    return predecessor(size(f.coeff));
+}
+
+template<typename T>
+    requires(Ring(T))
+void shift_add_in_place(polynomial<T>& f, const T& x_0)
+{
+    insert(back< array<T> >(f.coeff), x_0);
+    // Postcondition: f'(x) = x * f(x) + x_0
+}
+
+template<typename T>
+    requires(Ring(T))
+void shift_left_in_place(polynomial<T>& f, IndexType(polynomial<T>) n)
+{
+    // Precondition: n >= 0
+    reserve(f.coeff, size(f.coeff) + n); // one allocation for all n terms
+    while (count_down(n)) shift_add_in_place(f, T(0));
+    // Postcondition: f'(x) = x^n * f(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+T coefficient(const polynomial<T>& f, IndexType(polynomial<T>) i)
+{
+    // Precondition: $0 \leq i \leq \func{degree}(f)$
+    return f.coeff[degree(f) - i]; // not a reference, to guarantee the invariant holds
+}
+
+template<typename T>
+    requires(Ring(T))
+T lc(const polynomial<T>& f) // leading coefficient
+{
+    return f.coeff[0];
+    // Poscondition: returns coefficient(f, degree(f))
+}
+
+template<typename T>
+    requires(Ring(T))
+T tc(const polynomial<T>& f) // trailing coefficient
+{
+    return f.coeff[size(f.coeff) - 1];
+    // Poscondition: returns coefficient(f, 0)
+}
+
+template<typename T>
+    requires(Ring(T))
+bool monic(const polynomial<T>& f)
+{
+    return lc(f) == T(1);
+}
+
+template<typename T>
+    requires(Ring(T))
+polynomial<T> indeterminate()
+{
+    polynomial<T> f(T(1)); // f(x) = 1
+    shift_add_in_place(f, T(0)); // f'(x) = f(x) * x + 0 = 1 * x = x
+    return f; // could be a static const member
+    // Postcondition: returns f(x) = x
+}
+
+template<typename T>
+    requires(Ring(T))
+T evaluate(const polynomial<T>& f, const T& x_0)
+{
+    typedef IndexType(polynomial<T>) I;
+    I n(degree(f));
+    // Horner's scheme
+    T r = coefficient(f, n);
+    while (positive(n)) {
+        n = predecessor(n);
+        r = (r * x_0) + coefficient(f, n);
+    }
+    return r;
+    // Postcondition: r = f(x_0)
+}
+
+// Points evaluated together by evaluate_n
+const int polynomial_evaluate_lanes = 16;
+
+template<typename T, typename I, typename O>
+    requires(Ring(T) && Readable(I) && Iterator(I) && ValueType(I) == T &&
+        Writable(O) && Iterator(O) && ValueType(O) == T)
+O evaluate_n(const polynomial<T>& f, I x, DistanceType(I) n, O o)
+{
+    // Precondition: $\property{readable\_counted\_range}(x, n) \wedge
+    //                \property{writable\_counted\_range}(o, n)$
+    // Postcondition: $o[i] = f(x[i])$ for $0 \leq i < n$
+    // Horner's scheme on a block of points at a time: the loop over the
+    // points is innermost and has no dependences, so it vectorizes
+    typedef DistanceType(I) N;
+    typedef IndexType(polynomial<T>) D;
+    const int k = polynomial_evaluate_lanes;
+    D d = degree(f);
+    const pointer(T) c = begin(f.coeff);
+    array_k<k, T> y;
+    array_k<k, T> r;
+    while (!(n < N(k))) {
+        for (int j = 0; j < k; j = successor(j)) {
+            y[j] = source(x);
+            r[j] = c[0];
+            x = successor(x);
+        }
+        for (D i(1); i <= d; i = successor(i)) {
+            T a = c[i];
+            for (int j = 0; j < k; j = successor(j)) r[j] = r[j] * y[j] + a;
+        }
+        for (int j = 0; j < k; j = successor(j)) {
+            sink(o) = r[j];
+            o = successor(o);
+        }
+        n = n - N(k);
+    }
+    while (!zero(n)) {
+        sink(o) = evaluate(f, source(x));
+        x = successor(x);
+        o = successor(o);
+        n = predecessor(n);
+    }
+    return o;
+}
+
+template<typename T>
+    requires(Ring(T))
+polynomial<T> add(const polynomial<T>& f, const polynomial<T>& g,
+                  IndexType(polynomial<T>) d, IndexType(polynomial<T>) n_g)
+{
+    // Precondition: $0 < d = degree(f) - degree(g) \wedge n_g = degree(g)$
+    typedef IndexType(polynomial<T>) I;
+    polynomial<T> h(lc(f));
+    reserve(h.coeff, successor(d + n_g));
+    I i(1);
+    while (i != d) {
+        shift_add_in_place(h, f.coeff[i]);
+        i = successor(i);
+    }
+    I j(0);
+    while (j <= n_g) {
+        shift_add_in_place(h, f.coeff[i] + g.coeff[j]);
+        i = successor(i);
+        j = successor(j);
+    }
+    return h;
+    // Postcondition: h(x) = f(x) + g(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+polynomial<T> operator+(const polynomial<T>& f, const polynomial<T>& g)
+{
+    typedef IndexType(polynomial<T>) I;
+    I n_f = degree(f);
+    I n_g = degree(g);
+    if (n_f > n_g) return add(f, g, n_f - n_g, n_g);
+    else if (n_g > n_f) return add(g, f, n_g - n_f, n_f);
+    I i(0);
+    T x;
+    while (i <= n_f) {
+        x = f.coeff[i] + g.coeff[i];
+        if (x != T(0)) break;
+        i = successor(i);
+    }
+    polynomial<T> h(x);
+    reserve(h.coeff, successor(n_f - i));
+    while (i < n_f) {
+        i = successor(i);
+        shift_add_in_place(h, f.coeff[i] + g.coeff[i]);
+    };
+    return h;
+    // Postcondition: h(x) = f(x) + g(x)
+}
+
+template<typename T, typename F>
+    requires(Ring(T) && Transformation(F) &&
+        T == Domain(F))
+void transform_coefficients_in_place(polynomial<T>& f, F trans)
+{
+    typedef IndexType(polynomial<T>) I;
+    I i(0);
+    I n = degree(f);
+    while (i <= n) {
+        f.coeff[i] = trans(f.coeff[i]);
+        i = successor(i);
+    }
+}
+
+template<typename T>
+    requires(Ring(T))
+polynomial<T> operator-(polynomial<T> f) // f is a copy
+{
+    transform_coefficients_in_place(f, negate<T>());
+    return f;
+    // Postcondition: f'(x) = -f(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+polynomial<T> operator-(const polynomial<T>& f, const polynomial<T>& g)
+{
+    return f + (-g);
+    // Postcondition: returns h(x) = f(x) - g(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+polynomial<T> product(const polynomial<T>& f, const polynomial<T>& g)
+{
+    // Precondition: degree(f) <= degree(g)
+    typedef IndexType(polynomial<T>) I;
+    I n = successor(degree(f) + degree(g));
+    polynomial<T> h;
+    h.coeff = array<T>(n, n, T(0));
+    // Reversing both sequences reverses their convolution, so the
+    // highest-order-first coefficients need no reordering
+    convolution(begin(f.coeff), int(size(f.coeff)),
+                begin(g.coeff), int(size(g.coeff)), begin(h.coeff));
+    return h;
+    // Postcondition: h(x) = f(x) * g(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+polynomial<T> operator*(const polynomial<T>& f, const polynomial<T>& g)
+{
+    if (degree(f) <= degree(g)) return product(f, g);
+    else                        return product(g, f);
+}
+
+template<typename T>
+    requires(Ring(T))
+polynomial<T> operator*(T x_0, const polynomial<T>& f)
+{
+    polynomial<T> h(f);
+    transform_coefficients_in_place(
+        h, multiplies_transformation< multiplies<T> >(x_0, multiplies<T>()));
+    return h;
+    // Postcondition: h(x) = x_0 * f(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+polynomial<T> shift_left(const polynomial<T>& f, IndexType(polynomial<T>) n)
+{
+    polynomial<T> h;
+    h.coeff = array<T>(size(f.coeff) + n);
+    insert_range(back< array<T> >(h.coeff), f.coeff);
+    shift_left_in_place(h, n);
+    return h;
+    // Postcondition: h(x) = x^n * f(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+pair< polynomial<T>, polynomial<T> >
+quotient_remainder_schoolbook(const polynomial<T>& f, const polynomial<T>& g)
+{
+    // Precondition: unit(lc(g)) /\ degree(f) >= degree(g)
+    // Long division in place on a copy of the coefficients of f
+    typedef IndexType(polynomial<T>) I;
+    I n_f = degree(f);
+    I n_g = degree(g);
+    T u = multiplicative_inverse(lc(g));
+    I n_q = successor(n_f - n_g);
+    array<T> r(f.coeff);
+    polynomial<T> q;
+    q.coeff = array<T>(n_q, n_q, T(0));
+    I i(0);
+    while (i < n_q) {
+        // Invariant: f = q * g + r, with r[0, i) zero
+        T c = r[i] * u;
+        q.coeff[i] = c;
+        r[i] = T(0);
+        I j(1);
+        while (j <= n_g) {
+            r[i + j] = r[i + j] - c * g.coeff[j];
+            j = successor(j);
+        }
+        i = successor(i);
+    }
+    while (i < n_f && zero(r[i])) i = successor(i);
+    polynomial<T> s;
+    if (i <= n_f) s.coeff = array<T>(counted_range<pointer(T)>(begin(r) + i, n_f + 1 - i));
+    return pair< polynomial<T>, polynomial<T> >(q, s);
+    // Postcondition: f = q * g + r /\ degree(r) < degree(g)
+}
+
+// Divisions with a quotient and a divisor of at least this degree use
+// Newton's iteration
+const int polynomial_newton_threshold = 1024;
+
+template<typename T>
+    requires(Ring(T))
+void power_series_inverse(const pointer(T) g, int n_g, int n, pointer(T) h)
+{
+    // Precondition: $unit(g[0]) \wedge n > 0$
+    // Postcondition: $h[0, n)$ holds the terms of $1 / g$ below $x^n$,
+    //     where $g = \sum_{i < n_g} g[i] x^i$
+    // Newton's iteration doubles the number of correct terms each step:
+    // if $g h = 1 + x^k e \bmod x^{2k}$ then $g (h - x^k h e) = 1 \bmod x^{2k}$
+    h[0] = multiplicative_inverse(g[0]);
+    array<T> t(twice(n), twice(n), T(0));
+    array<T> e(n, n, T(0));
+    int k = 1;
+    while (k < n) {
+        int l = min(twice(k), n);
+        int m = min(l, n_g);
+        convolution(g, m, h, k, begin(t));
+        for (int i = 0; i < l - k; i = successor(i))
+            e[i] = k + i < m + k - 1 ? t[k + i] : T(0);
+        convolution(h, k, begin(e), l - k, begin(t));
+        for (int i = 0; i < l - k; i = successor(i)) h[k + i] = -t[i];
+        k = l;
+    }
+}
+
+template<typename T>
+    requires(Ring(T))
+pair< polynomial<T>, polynomial<T> >
+quotient_remainder_newton(const polynomial<T>& f, const polynomial<T>& g)
+{
+    // Precondition: unit(lc(g)) /\ degree(f) >= degree(g)
+    // Read lowest order first, the coefficients of f are those of its
+    // reversal $x^{n_f} f(1 / x)$, and the reversal of q is that of f
+    // divided by that of g, modulo $x^{n_q}$
+    typedef IndexType(polynomial<T>) I;
+    I n_f = degree(f);
+    I n_g = degree(g);
+    I n_q = successor(n_f - n_g);
+    array<T> h(n_q, n_q, T(0));
+    power_series_inverse(begin(g.coeff), int(successor(n_g)), int(n_q), begin(h));
+    array<T> t(twice(n_q) - 1, twice(n_q) - 1, T(0));
+    convolution(begin(f.coeff), int(n_q), begin(h), int(n_q), begin(t));
+    polynomial<T> q;
+    q.coeff = array<T>(counted_range<pointer(T)>(begin(t), n_q));
+    // $r = f - q g$ has only the $n_g$ lowest order terms
+    polynomial<T> p = q * g;
+    I i(n_q);
+    while (i < n_f && f.coeff[i] == p.coeff[i]) i = successor(i);
+    polynomial<T> r;
+    if (i <= n_f) {
+        r.coeff = array<T>(DistanceType(pointer(T))(successor(n_f - i)));
+        while (i <= n_f) {
+            insert(back< array<T> >(r.coeff), f.coeff[i] - p.coeff[i]);
+            i = successor(i);
+        }
+    }
+    return pair< polynomial<T>, polynomial<T> >(q, r);
+    // Postcondition: f = q * g + r /\ degree(r) < degree(g)
+}
+
+template<typename T>
+    requires(Ring(T))
+pair< polynomial<T>, polynomial<T> >
+quotient_remainder(const polynomial<T>& f, const polynomial<T>&g) {
+    // Precondition: unit(lc(g))
+    typedef IndexType(polynomial<T>) I;
+    I n_f = degree(f);
+    I n_g = degree(g);
+    if (n_f < n_g) return pair< polynomial<T>, polynomial<T> >(polynomial<T>(0), f);
+    if (!(n_f - n_g < I(polynomial_newton_threshold)) &&
+            !(n_g < I(polynomial_newton_threshold)))
+        return quotient_remainder_newton(f, g);
+    return quotient_remainder_schoolbook(f, g);
+    // Postcondition: f = q * g + r /\ degree(r) < degree(g)
+}
+
+template<typename T>
+    requires(Ring(T))
+polynomial<T> remainder(const polynomial<T>& f, const polynomial<T>&g) {
+    // Precondition: unit(lc(g))
+    return quotient_remainder(f, g).m1;
+}
+
+template<typename T>
+    requires(Ring(T))
+void print_coefficient(T c, IndexType(polynomial<T>) i)
+{
+    if (!one(c) || zero(i)) {
+        print(c);
+        if (positive(i)) print("*");
+    }
+    if (positive(i)) {
+        print("x");
+        if (i > IndexType(polynomial<T>)(1)) {
+            print("^"); print(i);
+        }
+    }
+}
+
+template<typename T>
+    requires(Ring(T))
+void print(const polynomial<T>& f)
+{
+    typedef IndexType(polynomial<T>) I;
+    print("polynomial(");
+        I i = degree(f);
+        T c = coefficient(f, i);
+        print_coefficient(c, i);
+        i = predecessor(i);
+        while (!negative(i)) {
+            c = coefficient(f, i);
+            if (!zero(c)) {
+                if (negative(c)) { print(" - "); c = -c; }
+                else               print(" + ");
+                print_coefficient(c, i);
+            }
+            i = predecessor(i);
+        }
+    print(")");
+}
+
+
+// Sparse polynomials
+
+// type sparse_polynomial
+// model PolynomialRing(sparse_polynomial)
+
+// A polynomial kept as its nonzero terms, each a pair of an exponent and a
+// coefficient, in decreasing order of exponent. Storage and the cost of
+// addition depend on the number of terms rather than on the degree, and
+// multiplication on the product of the numbers of terms.
+
+template<typename T>
+    requires(Ring(T))
+struct sparse_polynomial
+{
+    typedef int IndexType;
+    typedef pair<IndexType, T> Term;
+    array<Term> terms;
+    // Invariant: exponents strictly decrease and no coefficient is zero
+    sparse_polynomial() { }                                  // f(x) = 0
+    sparse_polynomial(T x_0) { monomial(x_0, 0); }            // f(x) = x_0
+    sparse_polynomial(T c, IndexType n) { monomial(c, n); }   // f(x) = c x^n
+    sparse_polynomial(const polynomial<T>& f)
+    {
+        IndexType n = degree(f);
+        IndexType i(0);
+        while (i <= n) {
+            if (!zero(f.coeff[i]))
+                insert(back< array<Term> >(terms), Term(n - i, f.coeff[i]));
+            i = successor(i);
+        }
+    }
+    void monomial(T c, IndexType n)
+    {
+        if (!zero(c)) insert(back< array<Term> >(terms), Term(n, c));
+    }
+};
+
+template<typename T>
+    requires(Ring(T))
+struct value_type< sparse_polynomial<T> >
+{
+    typedef T type;
+};
+
+template<typename T>
+    requires(Ring(T))
+struct index_type< sparse_polynomial<T> >
+{
+    typedef typename sparse_polynomial<T>::IndexType type;
+};
+
+template<typename T>
+    requires(Ring(T))
+bool operator==(const sparse_polynomial<T>& f, const sparse_polynomial<T>& g)
+{
+    return f.terms == g.terms;
+}
+
+template<typename T>
+    requires(Ring(T))
+IndexType(sparse_polynomial<T>) degree(const sparse_polynomial<T>& f)
+{
+    // As for polynomial, the zero polynomial has degree 0
+    typedef IndexType(sparse_polynomial<T>) I;
+    if (empty(f.terms)) return I(0);
+    return f.terms[0].m0;
+}
+
+template<typename T>
+    requires(Ring(T))
+bool operator<(const sparse_polynomial<T>& f, const sparse_polynomial<T>& g)
+{
+    return degree(f) < degree(g) ||
+          degree(g) == degree(f) && f.terms < g.terms;
+}
+
+template<typename T>
+    requires(Ring(T))
+T coefficient(const sparse_polynomial<T>& f, IndexType(sparse_polynomial<T>) i)
+{
+    // Binary search for the term with exponent $i$
+    typedef typename sparse_polynomial<T>::Term Term;
+    typedef DistanceType(pointer(Term)) N;
+    N l(0);
+    N h = size(f.terms);
+    while (l < h) {
+        N m = l + half_nonnegative(h - l);
+        if (i < f.terms[m].m0) l = successor(m);
+        else                   h = m;
+    }
+    if (l < size(f.terms) && f.terms[l].m0 == i) return f.terms[l].m1;
+    return T(0);
+}
+
+template<typename T>
+    requires(Ring(T))
+T lc(const sparse_polynomial<T>& f) // leading coefficient
+{
+    if (empty(f.terms)) return T(0);
+    return f.terms[0].m1;
+}
+
+template<typename T>
+    requires(Ring(T))
+T tc(const sparse_polynomial<T>& f) // trailing coefficient
+{
+    return coefficient(f, IndexType(sparse_polynomial<T>)(0));
+}
+
+template<typename T>
+    requires(Ring(T))
+bool monic(const sparse_polynomial<T>& f)
+{
+    return lc(f) == T(1);
+}
+
+template<typename T>
+    requires(Ring(T))
+sparse_polynomial<T> sparse_indeterminate()
+{
+    return sparse_polynomial<T>(T(1), 1);
+    // Postcondition: returns f(x) = x
+}
+
+template<typename T>
+    requires(Ring(T))
+T evaluate(const sparse_polynomial<T>& f, const T& x_0)
+{
+    // Horner's scheme, raising $x_0$ to the gap between exponents
+    typedef typename sparse_polynomial<T>::Term Term;
+    typedef DistanceType(pointer(Term)) N;
+    N n = size(f.terms);
+    if (zero(n)) return T(0);
+    multiplies<T> op;
+    T r = f.terms[0].m1;
+    N i(1);
+    while (i < n) {
+        r = r * power(x_0, f.terms[i - 1].m0 - f.terms[i].m0, op) + f.terms[i].m1;
+        i = successor(i);
+    }
+    if (positive(f.terms[n - 1].m0)) r = r * power(x_0, f.terms[n - 1].m0, op);
+    return r;
+    // Postcondition: r = f(x_0)
+}
+
+template<typename T>
+    requires(Ring(T))
+sparse_polynomial<T> operator+(const sparse_polynomial<T>& f,
+                               const sparse_polynomial<T>& g)
+{
+    // Merges the terms in decreasing order of exponent
+    typedef typename sparse_polynomial<T>::Term Term;
+    typedef DistanceType(pointer(Term)) N;
+    N n_f = size(f.terms);
+    N n_g = size(g.terms);
+    sparse_polynomial<T> h;
+    h.terms = array<Term>(n_f + n_g);
+    back< array<Term> > o(h.terms);
+    N i(0);
+    N j(0);
+    while (i < n_f && j < n_g) {
+        if (g.terms[j].m0 < f.terms[i].m0) {
+            insert(o, f.terms[i]); i = successor(i);
+        } else if (f.terms[i].m0 < g.terms[j].m0) {
+            insert(o, g.terms[j]); j = successor(j);
+        } else {
+            T c = f.terms[i].m1 + g.terms[j].m1;
+            if (!zero(c)) insert(o, Term(f.terms[i].m0, c));
+            i = successor(i); j = successor(j);
+        }
+    }
+    while (i < n_f) { insert(o, f.terms[i]); i = successor(i); }
+    while (j < n_g) { insert(o, g.terms[j]); j = successor(j); }
+    return h;
+    // Postcondition: h(x) = f(x) + g(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+sparse_polynomial<T> operator*(T x_0, const sparse_polynomial<T>& f)
+{
+    typedef typename sparse_polynomial<T>::Term Term;
+    typedef DistanceType(pointer(Term)) N;
+    sparse_polynomial<T> h;
+    h.terms = array<Term>(size(f.terms));
+    N i(0);
+    while (i < size(f.terms)) {
+        T c = x_0 * f.terms[i].m1;
+        if (!zero(c)) insert(back< array<Term> >(h.terms), Term(f.terms[i].m0, c));
+        i = successor(i);
+    }
+    return h;
+    // Postcondition: h(x) = x_0 * f(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+sparse_polynomial<T> operator-(const sparse_polynomial<T>& f)
+{
+    return T(-1) * f;
+    // Postcondition: returns h(x) = -f(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+sparse_polynomial<T> operator-(const sparse_polynomial<T>& f,
+                               const sparse_polynomial<T>& g)
+{
+    return f + (-g);
+    // Postcondition: returns h(x) = f(x) - g(x)
+}
+
+template<typename H>
+    requires(H == triple<Integer, int, int>)
+void sift_down_exponent(pointer(H) h, int n)
+{
+    // Precondition: $h[1, n)$ is a max-heap on $m0$
+    // Postcondition: $h[0, n)$ is a max-heap on $m0$
+    H x = h[0];
+    int i(0);
+    while (true) {
+        int c = twice(i) + 1;
+        if (!(c < n)) break;
+        if (c + 1 < n && h[c].m0 < h[c + 1].m0) c = successor(c);
+        if (!(x.m0 < h[c].m0)) break;
+        h[i] = h[c];
+        i = c;
+    }
+    h[i] = x;
+}
+
+template<typename T>
+    requires(Ring(T))
+sparse_polynomial<T> operator*(const sparse_polynomial<T>& f,
+                               const sparse_polynomial<T>& g)
+{
+    // Johnson's algorithm: f g is the merge of the term streams
+    // $f_i g$, one per term of the shorter factor, each in decreasing
+    // order of exponent. A heap of the heads of the streams yields the
+    // terms of the product in order, so like terms arrive together and
+    // no intermediate sum is formed
+    typedef IndexType(sparse_polynomial<T>) I;
+    typedef typename sparse_polynomial<T>::Term Term;
+    typedef triple<I, int, int> H; // exponent, term of f, term of g
+    if (size(g.terms) < size(f.terms)) return g * f;
+    int n_f = int(size(f.terms));
+    int n_g = int(size(g.terms));
+    sparse_polynomial<T> r;
+    if (zero(n_f)) return r;
+    // The heads $f_i g_0$ are in decreasing order, so already a heap
+    array<H> h(n_f, n_f, H(I(0), 0, 0));
+    for (int i = 0; i < n_f; i = successor(i))
+        h[i] = H(f.terms[i].m0 + g.terms[0].m0, i, 0);
+    int n = n_f;
+    while (positive(n)) {
+        I e = h[0].m0;
+        T c(0);
+        do {
+            int i = h[0].m1;
+            int j = h[0].m2;
+            c = c + f.terms[i].m1 * g.terms[j].m1;
+            j = successor(j);
+            if (j < n_g) h[0] = H(f.terms[i].m0 + g.terms[j].m0, i, j);
+            else {
+                n = predecessor(n);
+                h[0] = h[n];
+            }
+            sift_down_exponent(begin(h), n);
+        } while (positive(n) && h[0].m0 == e);
+        if (!zero(c)) insert(back< array<Term> >(r.terms), Term(e, c));
+    }
+    return r;
+    // Postcondition: r(x) = f(x) * g(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+sparse_polynomial<T> shift_left(const sparse_polynomial<T>& f,
+                                IndexType(sparse_polynomial<T>) n)
+{
+    // Precondition: n >= 0
+    sparse_polynomial<T> h(f);
+    shift_left_in_place(h, n);
+    return h;
+    // Postcondition: h(x) = x^n * f(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+void shift_left_in_place(sparse_polynomial<T>& f,
+                         IndexType(sparse_polynomial<T>) n)
+{
+    // Precondition: n >= 0
+    typedef DistanceType(pointer(typename sparse_polynomial<T>::Term)) N;
+    N i(0);
+    while (i < size(f.terms)) {
+        f.terms[i].m0 = f.terms[i].m0 + n;
+        i = successor(i);
+    }
+    // Postcondition: f'(x) = x^n * f(x)
+}
+
+template<typename T>
+    requires(Ring(T))
+pair< sparse_polynomial<T>, sparse_polynomial<T> >
+quotient_remainder(const sparse_polynomial<T>& f, const sparse_polynomial<T>& g)
+{
+    // Precondition: unit(lc(g))
+    // Long division; each step merges one multiple of g into the remainder
+    typedef sparse_polynomial<T> P;
+    typedef typename P::Term Term;
+    T u = multiplicative_inverse(lc(g));
+    P q;
+    P r = f;
+    while (!empty(r.terms) && !(degree(r) < degree(g))) {
+        // Invariant: f = q * g + r
+        Term t(degree(r) - degree(g), lc(r) * u);
+        insert(back< array<Term> >(q.terms), t);
+        r = r - shift_left(t.m1 * g, t.m0);
+    }
+    return pair<P, P>(q, r);
+    // Postcondition: f = q * g + r /\ degree(r) < degree(g)
+}
+
+template<typename T>
+    requires(Ring(T))
+sparse_polynomial<T> remainder(const sparse_polynomial<T>& f,
+                               const sparse_polynomial<T>& g)
+{
+    // Precondition: unit(lc(g))
+    return quotient_remainder(f, g).m1;
+}
+
+template<typename T>
+    requires(Ring(T))
+void print(const sparse_polynomial<T>& f)
+{
+    typedef DistanceType(pointer(typename sparse_polynomial<T>::Term)) N;
+    print("sparse_polynomial(");
+        if (empty(f.terms)) print(T(0));
+        N i(0);
+        while (i < size(f.terms)) {
+            T c = f.terms[i].m1;
+            if (positive(i)) {
+                if (negative(c)) { print(" - "); c = -c; }
+                else               print(" + ");
+            }
+            print_coefficient(c, f.terms[i].m0);
+            i = successor(i);
+        }
+    print(")");
+}
+
+
+#endif // EOP_POLYNOMIALS
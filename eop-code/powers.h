@@ -0,0 +1,421 @@
+// powers.h
+
+// Copyright (c) 2009 Alexander Stepanov and Paul McJones
+//
+// Permission to use, copy, modify, distribute and sell this software
+// and its documentation for any purpose is hereby granted without
+// fee, provided that the above copyright notice appear in all copies
+// and that both that copyright notice and this permission notice
+// appear in supporting documentation. The authors make no
+// representations about the suitability of this software for any
+// purpose. It is provided "as is" without express or implied
+// warranty.
+
+
+// Power algorithms extending Chapter 3 of
+// Elements of Programming
+// by Alexander Stepanov and Paul McJones
+// Addison-Wesley Professional, 2009
+
+
+#ifndef EOP_POWERS
+#define EOP_POWERS
+
+
+#include "intrinsics.h"
+#include "type_functions.h"
+#include "eop.h"
+
+
+// Addition chains for constant exponents
+
+// $\func{addition\_chain}<n>$ chooses at compile time the shorter of
+//     $a^n = (a^d)^{n/d}$ for the best divisor $1 < d \leq \sqrt{n}$, and
+//     $a^n = a^{n-1} a$ for odd $n$,
+// recursively (the factor method). Since $d = 2$ is a halving and the
+// second case covers an odd exponent, the chain is never longer than the
+// one the binary method of $\func{power}$ follows; for $n = 15$ it takes
+// 5 operations ($a^3$, then its fifth power) instead of 6.
+// $factor$ is the chosen divisor, or 0 for the second case, and $length$
+// is the number of operations
+
+template<int n>
+struct addition_chain;
+
+template<int n, int d, bool divides = n % d == 0>
+struct addition_chain_divisor
+{
+    static const int length = n; // longer than any chain
+};
+
+template<int n, int d>
+struct addition_chain_divisor<n, d, true>
+{
+    static const int length =
+        addition_chain<d>::length + addition_chain<n / d>::length;
+};
+
+template<int n, int d, bool done = (n < d * d)>
+struct addition_chain_factor
+{
+    // The best divisor of $n$ in $[d, \sqrt{n}]$, the largest among equals
+    typedef addition_chain_factor<n, d + 1> rest;
+    static const int here = addition_chain_divisor<n, d>::length;
+    static const bool first = here < rest::length;
+    static const int factor = first ? d : rest::factor;
+    static const int length = first ? here : rest::length;
+};
+
+template<int n, int d>
+struct addition_chain_factor<n, d, true>
+{
+    static const int factor = 0;
+    static const int length = n;
+};
+
+template<int n, bool odd = (n % 2 == 1)>
+struct addition_chain_step
+{
+    static const int length = n; // even exponents are split
+};
+
+template<int n>
+struct addition_chain_step<n, true>
+{
+    static const int length = addition_chain<n - 1>::length + 1;
+};
+
+template<int n>
+struct addition_chain
+{
+    // Precondition: $n > 0$
+    typedef addition_chain_factor<n, 2> split;
+    static const int length_step = addition_chain_step<n>::length;
+    static const int factor =
+        split::length <= length_step ? split::factor : 0;
+    static const int length =
+        split::length <= length_step ? split::length : length_step;
+};
+
+template<>
+struct addition_chain<1>
+{
+    static const int factor = 0;
+    static const int length = 0;
+};
+
+template<>
+struct addition_chain<2>
+{
+    static const int factor = 0;
+    static const int length = 1;
+};
+
+template<int n, int d = addition_chain<n>::factor>
+struct power_chain
+{
+    // $a^n = (a^d)^{n/d}$
+    template<typename Op>
+        requires(BinaryOperation(Op))
+    static Domain(Op) apply(const Domain(Op)& a, Op op)
+    {
+        return power_chain<n / d>::apply(power_chain<d>::apply(a, op), op);
+    }
+};
+
+template<int n>
+struct power_chain<n, 0>
+{
+    // $a^n = a^{n-1} a$
+    template<typename Op>
+        requires(BinaryOperation(Op))
+    static Domain(Op) apply(const Domain(Op)& a, Op op)
+    {
+        return op(power_chain<n - 1>::apply(a, op), a);
+    }
+};
+
+template<>
+struct power_chain<1, 0>
+{
+    template<typename Op>
+        requires(BinaryOperation(Op))
+    static Domain(Op) apply(const Domain(Op)& a, Op)
+    {
+        return a;
+    }
+};
+
+template<int n, typename Op>
+    requires(BinaryOperation(Op))
+Domain(Op) power(const Domain(Op)& a, Op op)
+{
+    // Precondition: $\func{associative}(op) \wedge n > 0$
+    // Postcondition: same as $\func{power}(a, n, op)$ with
+    //     $\func{addition\_chain}<n>::length$ applications of $op$
+    return power_chain<n>::apply(a, op);
+}
+
+template<int n, typename Op>
+    requires(BinaryOperation(Op))
+Domain(Op) power_accumulate_positive(const Domain(Op)& r,
+                                     const Domain(Op)& a, Op op)
+{
+    // Precondition: $\func{associative}(op) \wedge n > 0$
+    return op(r, power<n>(a, op));
+}
+
+
+// Windowed powers
+
+// For a costly $op$ the binary method of $\func{power}$ spends about
+// $\log_2 n$ squarings plus one multiplication per 1-bit of $n$.
+// The windowed methods keep the squarings but multiply once per window of
+// $k$ bits, by a power taken from a table precomputed from $a$: all of
+// $a^1, \ldots, a^{2^k - 1}$ for the $k$-ary method, only the odd ones for
+// the sliding window method, whose windows start and end with a 1-bit.
+// The window is chosen from the bits of $n$ by counting the operations
+// each size would take, so neither is ever worse than the binary method
+
+template<typename I>
+    requires(Integer(I))
+int power_bits(I n, array<bool>& b)
+{
+    // Precondition: $\func{positive}(n)$
+    // Postcondition: $b[i]$ is bit $i$ of $n$; returns the number of bits
+    int l(0);
+    for (I m = n; !zero(m); m = half_nonnegative(m)) l = successor(l);
+    b = array<bool>(l, l, false);
+    for (int i = 0; i < l; i = successor(i)) {
+        b[i] = odd(n);
+        n = half_nonnegative(n);
+    }
+    return l;
+}
+
+int power_k_ary_operations(const array<bool>& b, int l, int k)
+{
+    // Returns the number of operations of $\func{power\_k\_ary}$ with
+    // window $k$ for the exponent with the $l$ bits $b$
+    int c = (1 << k) - 2;
+    for (int i = (l - 1) / k * k - k; i >= 0; i = i - k) {
+        c = c + k;
+        int j = i;
+        while (j < i + k && !b[j]) j = successor(j);
+        if (j < i + k) c = successor(c);
+    }
+    return c;
+}
+
+int power_sliding_window_operations(const array<bool>& b, int l, int k)
+{
+    // Returns the number of operations of $\func{power\_sliding\_window}$
+    // with window $k$ for the exponent with the $l$ bits $b$
+    int c = k == 1 ? 0 : 1 << (k - 1);
+    int i = l - 1;
+    while (i >= 0) {
+        if (!b[i]) { c = successor(c); i = predecessor(i); continue; }
+        int j = i - k + 1;
+        if (j < 0) j = 0;
+        while (!b[j]) j = successor(j);
+        if (i != l - 1) c = c + i - j + 2;
+        i = predecessor(j);
+    }
+    return c;
+}
+
+template<typename F>
+    requires(Procedure(F) && Arity(F) == 3)
+int power_window_size(const array<bool>& b, int l, F operations)
+{
+    // Returns the window with the fewest operations; tables larger than
+    // the exponent has bits cannot pay off
+    int k(1);
+    int c = operations(b, l, 1);
+    for (int h = 2; (1 << (h - 1)) <= l; h = successor(h)) {
+        int d = operations(b, l, h);
+        if (d < c) { k = h; c = d; }
+    }
+    return k;
+}
+
+template<typename Op>
+    requires(BinaryOperation(Op))
+Domain(Op) power_k_ary_bits(Domain(Op) a, const array<bool>& b, int l, Op op,
+                            int k)
+{
+    // Precondition: $\func{associative}(op) \wedge k > 0$
+    // Precondition: $b$ holds the $l > 0$ bits of the exponent
+    typedef Domain(Op) T;
+    int m = 1 << k;
+    array<T> t(m, m, a);       // $t[d] = a^d$ for $0 < d < m$
+    for (int d = 2; d < m; d = successor(d)) t[d] = op(t[d - 1], a);
+    int i = (l - 1) / k * k;   // the most significant digit starts at bit $i$
+    int d(0);
+    for (int j = l - 1; j >= i; j = predecessor(j)) d = twice(d) + int(b[j]);
+    T r = t[d];
+    while (i > 0) {
+        i = i - k;
+        d = 0;
+        for (int j = i + k - 1; j >= i; j = predecessor(j)) {
+            r = op(r, r);
+            d = twice(d) + int(b[j]);
+        }
+        if (d != 0) r = op(r, t[d]);
+    }
+    return r;
+}
+
+template<typename I, typename Op>
+    requires(Integer(I) && BinaryOperation(Op))
+Domain(Op) power_k_ary(Domain(Op) a, I n, Op op)
+{
+    // Precondition: $\func{associative}(op) \wedge \func{positive}(n)$
+    array<bool> b;
+    int l = power_bits(n, b);
+    return power_k_ary_bits(a, b, l, op,
+                            power_window_size(b, l, power_k_ary_operations));
+}
+
+template<typename I, typename Op>
+    requires(Integer(I) && BinaryOperation(Op))
+Domain(Op) power_k_ary(Domain(Op) a, I n, Op op, int k)
+{
+    // Precondition: $\func{associative}(op) \wedge \func{positive}(n) \wedge k > 0$
+    array<bool> b;
+    int l = power_bits(n, b);
+    return power_k_ary_bits(a, b, l, op, k);
+}
+
+template<typename Op>
+    requires(BinaryOperation(Op))
+Domain(Op) power_sliding_window_bits(Domain(Op) a, const array<bool>& b,
+                                     int l, Op op, int k)
+{
+    // Precondition: $\func{associative}(op) \wedge k > 0$
+    // Precondition: $b$ holds the $l > 0$ bits of the exponent
+    typedef Domain(Op) T;
+    int m = 1 << (k - 1);
+    array<T> t(m, m, a);       // $t[d] = a^{2 d + 1}$
+    if (m > 1) {
+        T a2 = op(a, a);
+        for (int d = 1; d < m; d = successor(d)) t[d] = op(t[d - 1], a2);
+    }
+    int i = l - 1;             // the top bit is 1
+    T r = a;
+    bool first = true;
+    while (i >= 0) {
+        if (!b[i]) {
+            r = op(r, r);
+            i = predecessor(i);
+            continue;
+        }
+        int j = i - k + 1;     // the window $[j, i]$ ends with a 1-bit
+        if (j < 0) j = 0;
+        while (!b[j]) j = successor(j);
+        int d(0);
+        for (int h = i; h >= j; h = predecessor(h)) {
+            if (!first) r = op(r, r);
+            d = twice(d) + int(b[h]);
+        }
+        if (first) r = t[half_nonnegative(d)];
+        else       r = op(r, t[half_nonnegative(d)]);
+        first = false;
+        i = predecessor(j);
+    }
+    return r;
+}
+
+template<typename I, typename Op>
+    requires(Integer(I) && BinaryOperation(Op))
+Domain(Op) power_sliding_window(Domain(Op) a, I n, Op op)
+{
+    // Precondition: $\func{associative}(op) \wedge \func{positive}(n)$
+    array<bool> b;
+    int l = power_bits(n, b);
+    return power_sliding_window_bits(a, b, l, op,
+        power_window_size(b, l, power_sliding_window_operations));
+}
+
+template<typename I, typename Op>
+    requires(Integer(I) && BinaryOperation(Op))
+Domain(Op) power_sliding_window(Domain(Op) a, I n, Op op, int k)
+{
+    // Precondition: $\func{associative}(op) \wedge \func{positive}(n) \wedge k > 0$
+    array<bool> b;
+    int l = power_bits(n, b);
+    return power_sliding_window_bits(a, b, l, op, k);
+}
+
+template<typename I, typename Op>
+    requires(Integer(I) && BinaryOperation(Op))
+Domain(Op) power_accumulate_sliding_window(Domain(Op) r, Domain(Op) a, I n,
+                                           Op op)
+{
+    // Precondition: $\func{associative}(op) \wedge \neg \func{negative}(n)$
+    // Postcondition: same as $\func{power\_accumulate}(r, a, n, op)$
+    if (zero(n)) return r;
+    return op(r, power_sliding_window(a, n, op));
+}
+
+// Modular arithmetic without overflow
+
+// For $0 \leq x, y < m$ these never form a value above $m$, so they work
+// for any modulus representable in $I$, at the cost of $\func{power}$
+// taking about $2 \log_2 y$ additions for one multiplication; contrast
+// $\func{multiplies\_modulo}$ (drivers.h), which needs $(m - 1)^2$ to
+// fit, and the wide multiplications of multiprecision.h
+
+template<typename I>
+    requires(Integer(I))
+struct plus_modulo_no_overflow
+{
+    I m;
+    plus_modulo_no_overflow(I m) : m(m) { }
+    I operator()(I x, I y)
+    {
+        // Precondition: $0 \leq x, y < m$
+        if (x < m - y) return x + y;
+        return x - (m - y);
+    }
+};
+
+template<typename I>
+    requires(Integer(I))
+struct input_type<plus_modulo_no_overflow<I>, 0>
+{
+    typedef I type;
+};
+
+template<typename I>
+    requires(Integer(I))
+I multiply_modulo_no_overflow(I x, I y, I m)
+{
+    // Precondition: $0 \leq x, y < m$
+    // Russian peasant multiplication: $x y$ is the power of $x$ under
+    // addition, so no intermediate result exceeds $m$
+    if (zero(y)) return I(0);
+    return power(x, y, plus_modulo_no_overflow<I>(m));
+}
+
+template<typename I>
+    requires(Integer(I))
+struct multiplies_modulo_no_overflow
+{
+    I m;
+    multiplies_modulo_no_overflow(I m) : m(m) { }
+    I operator()(I x, I y)
+    {
+        // Precondition: $0 \leq x, y < m$
+        return multiply_modulo_no_overflow(x, y, m);
+    }
+};
+
+template<typename I>
+    requires(Integer(I))
+struct input_type<multiplies_modulo_no_overflow<I>, 0>
+{
+    typedef I type;
+};
+
+#endif // EOP_POWERS
@@ -0,0 +1,244 @@
+// rationals.h
+
+// Copyright (c) 2009 Alexander Stepanov and Paul McJones
+//
+// Permission to use, copy, modify, distribute and sell this software
+// and its documentation for any purpose is hereby granted without
+// fee, provided that the above copyright notice appear in all copies
+// and that both that copyright notice and this permission notice
+// appear in supporting documentation. The authors make no
+// representations about the suitability of this software for any
+// purpose. It is provided "as is" without express or implied
+// warranty.
+
+
+// Rational numbers extending Chapter 5 of
+// Elements of Programming
+// by Alexander Stepanov and Paul McJones
+// Addison-Wesley Professional, 2009
+
+
+#ifndef EOP_RATIONALS
+#define EOP_RATIONALS
+
+
+#include "intrinsics.h"
+#include "type_functions.h"
+#include "eop.h"
+#include "euclidean.h"
+#include "print.h"
+
+
+// type lazy_rational
+// model DiscreteArchimedeanField(lazy_rational)
+
+// A rational number over a built-in integer type $N$, kept with a positive
+// denominator but not necessarily in lowest terms. Every operation forms
+// its result in $\func{WideType}(N)$, where no product of two values of $N$
+// overflows, and only reduces it when the result does not fit in $N$.
+// Equality and order are decided by cross multiplication in the wide type,
+// so they never need to reduce; $\func{normalize}$ and $\func{print}$ do.
+
+template<typename N>
+    requires(Integer(N))
+struct lazy_rational
+{
+    N p;                       // numerator
+    N q;                       // denominator, positive
+    lazy_rational() { }
+    lazy_rational(N x) : p(x), q(N(1)) { }
+    lazy_rational(N p, N q) : p(q < N(0) ? -p : p), q(q < N(0) ? -q : q)
+    {
+        // Precondition: $q \neq 0 \wedge p, q > \min(N)$
+        Assert(q != N(0));
+    }
+};
+
+template<typename N>
+    requires(Integer(N))
+struct quotient_type< lazy_rational<N> >
+{
+    typedef N type;
+};
+
+template<typename N>
+    requires(Integer(N))
+bool fits(WideType(N) x)
+{
+    return x == WideType(N)(N(x));
+}
+
+template<typename N>
+    requires(Integer(N))
+lazy_rational<N> lazy_rational_fit(WideType(N) p, WideType(N) q)
+{
+    // Precondition: $q > 0$ and $p / q$ in lowest terms fits in $N$
+    // Postcondition: returns $p / q$, reduced only if $p$ or $q$ does not
+    //     fit in $N$
+    typedef WideType(N) W;
+    typedef DistanceType(W) U;
+    lazy_rational<N> x;
+    if (!fits<N>(p) || !fits<N>(q)) {
+        W g = W(binary_gcd_nonnegative(magnitude(p), U(q)));
+        p = p / g;
+        q = q / g;
+        Assert(fits<N>(p) && fits<N>(q));
+    }
+    x.p = N(p);
+    x.q = N(q);
+    return x;
+}
+
+template<typename N>
+    requires(Integer(N))
+lazy_rational<N> normalize(const lazy_rational<N>& x)
+{
+    // Postcondition: equal to $x$, in lowest terms
+    typedef DistanceType(N) U;
+    N g = N(binary_gcd_nonnegative(magnitude(x.p), U(x.q)));
+    lazy_rational<N> y;
+    y.p = x.p / g;
+    y.q = x.q / g;
+    return y;
+}
+
+template<typename I>
+    requires(Mutable(I) && ForwardIterator(I) &&
+        ValueType(I) == lazy_rational<QuotientType(ValueType(I))>)
+I normalize_n(I f, DistanceType(I) n)
+{
+    // Precondition: $\func{mutable\_counted\_range}(f, n)$
+    // Postcondition: every element is in lowest terms
+    // The gcds are computed a block at a time by $\func{gcd\_n}$
+    typedef DistanceType(I) D;
+    typedef QuotientType(ValueType(I)) N;
+    const int k = 16 * gcd_lanes;
+    array_k<k, N> p, q, g;
+    while (!zero(n)) {
+        int m = n < D(k) ? int(n) : k;
+        I h = f;
+        for (int i = 0; i < m; i = successor(i)) {
+            p[i] = source(h).p;
+            q[i] = source(h).q;
+            h = successor(h);
+        }
+        gcd_n(&p[0], m, &q[0], &g[0]);
+        for (int i = 0; i < m; i = successor(i)) {
+            sink(f).p = p[i] / g[i];
+            sink(f).q = q[i] / g[i];
+            f = successor(f);
+        }
+        n = n - D(m);
+    }
+    return f;
+}
+
+template<typename N>
+    requires(Integer(N))
+lazy_rational<N> operator+(const lazy_rational<N>& x, const lazy_rational<N>& y)
+{
+    typedef WideType(N) W;
+    if (x.q == y.q) return lazy_rational_fit<N>(W(x.p) + W(y.p), W(x.q));
+    return lazy_rational_fit<N>(W(x.p) * W(y.q) + W(y.p) * W(x.q),
+                                W(x.q) * W(y.q));
+}
+
+template<typename N>
+    requires(Integer(N))
+lazy_rational<N> operator-(const lazy_rational<N>& x)
+{
+    lazy_rational<N> y;
+    y.p = -x.p;
+    y.q = x.q;
+    return y;
+}
+
+template<typename N>
+    requires(Integer(N))
+lazy_rational<N> operator-(const lazy_rational<N>& x, const lazy_rational<N>& y)
+{
+    typedef WideType(N) W;
+    if (x.q == y.q) return lazy_rational_fit<N>(W(x.p) - W(y.p), W(x.q));
+    return lazy_rational_fit<N>(W(x.p) * W(y.q) - W(y.p) * W(x.q),
+                                W(x.q) * W(y.q));
+}
+
+template<typename N>
+    requires(Integer(N))
+lazy_rational<N> operator*(const lazy_rational<N>& x, const lazy_rational<N>& y)
+{
+    typedef WideType(N) W;
+    return lazy_rational_fit<N>(W(x.p) * W(y.p), W(x.q) * W(y.q));
+}
+
+template<typename N>
+    requires(Integer(N))
+lazy_rational<N> multiplicative_inverse(const lazy_rational<N>& x)
+{
+    // Precondition: $x.p \neq 0$
+    return lazy_rational<N>(x.q, x.p);
+}
+
+template<typename N>
+    requires(Integer(N))
+lazy_rational<N> operator/(const lazy_rational<N>& x, const lazy_rational<N>& y)
+{
+    // Precondition: $y.p \neq 0$
+    typedef WideType(N) W;
+    W p = W(x.p) * W(y.q);
+    W q = W(x.q) * W(y.p);
+    if (q < W(0)) { p = -p; q = -q; }
+    return lazy_rational_fit<N>(p, q);
+}
+
+// Multiplication for lazy_rational<N> as a semimodule over integers
+
+template<typename N>
+    requires(Integer(N))
+lazy_rational<N> operator*(const N& n, const lazy_rational<N>& x)
+{
+    typedef WideType(N) W;
+    return lazy_rational_fit<N>(W(n) * W(x.p), W(x.q));
+}
+
+template<typename N>
+    requires(Integer(N))
+lazy_rational<N> remainder(const lazy_rational<N>& x, const lazy_rational<N>& y)
+{
+    // Precondition: $y \neq 0$
+    // Postcondition: $x - n y$ for the integer $n$ truncating $x / y$;
+    //     over the common denominator it is a single remainder of integers
+    typedef WideType(N) W;
+    return lazy_rational_fit<N>((W(x.p) * W(y.q)) % (W(y.p) * W(x.q)),
+                                W(x.q) * W(y.q));
+}
+
+template<typename N>
+    requires(Integer(N))
+bool operator==(const lazy_rational<N>& x, const lazy_rational<N>& y)
+{
+    typedef WideType(N) W;
+    return W(x.p) * W(y.q) == W(y.p) * W(x.q);
+}
+
+template<typename N>
+    requires(Integer(N))
+bool operator<(const lazy_rational<N>& x, const lazy_rational<N>& y)
+{
+    typedef WideType(N) W;
+    return W(x.p) * W(y.q) < W(y.p) * W(x.q);
+}
+
+template<typename N>
+    requires(Integer(N))
+void print(const lazy_rational<N>& x)
+{
+    lazy_rational<N> y = normalize(x);
+    if (zero(y.p)) print("0");
+    else if (one(y.q)) print(y.p);
+    else {
+        print(y.p); print("/"); print(y.q);
+    }
+}
+
+#endif // EOP_RATIONALS
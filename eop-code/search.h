@@ -0,0 +1,309 @@
+// search.h
+
+// Copyright (c) 2009 Alexander Stepanov and Paul McJones
+//
+// Permission to use, copy, modify, distribute and sell this software
+// and its documentation for any purpose is hereby granted without
+// fee, provided that the above copyright notice appear in all copies
+// and that both that copyright notice and this permission notice
+// appear in supporting documentation. The authors make no
+// representations about the suitability of this software for any
+// purpose. It is provided "as is" without express or implied
+// warranty.
+
+
+// Static search indexes extending Chapter 6 of
+// Elements of Programming
+// by Alexander Stepanov and Paul McJones
+// Addison-Wesley Professional, 2009
+
+
+#ifndef EOP_SEARCH
+#define EOP_SEARCH
+
+
+#include "intrinsics.h"
+#include "type_functions.h"
+#include "eop.h"
+
+
+// B-tree layout
+
+// $\func{partition\_point\_n}$ halves a sorted range at each step, and on a
+// large range each of the last steps reads a different cache line. A
+// $\func{btree\_index}$ holds a copy of the range as an implicit B-tree
+// whose nodes are $b$ elements filling one cache line. Layer 0 is a copy
+// of the range, padded with copies of its last element to whole nodes;
+// node $k$ of layer $h + 1$ has children $k (b + 1) + j$ for
+// $0 \leq j \leq b$ in layer $h$, and its key $j$ is the first element of
+// the range below child $j + 1$. Searching a node counts the keys not
+// satisfying the predicate, which selects the child without a branch, so a
+// search reads one line per layer, $\lceil \log_{b+1} n \rceil$ in all,
+// instead of one per halving. The layers are stored from the root down,
+// starting on a cache line boundary
+
+const int cache_line_size = 64;
+
+template<typename T>
+    requires(Regular(T))
+int btree_node_size()
+{
+    // The largest power of two $b$ with $b$ elements in a cache line,
+    // or 1 if none fits
+    int b = 1;
+    while (int(sizeof(T)) * twice(b) <= cache_line_size) b = twice(b);
+    return b;
+}
+
+template<typename I>
+    requires(Readable(I) && RandomAccessIterator(I))
+struct btree_index
+{
+    typedef ValueType(I) T;
+    typedef DistanceType(I) N;
+    I f;
+    N n;
+    int h;       // number of layers
+    N o[64];     // o[i] is the index in x of the first node of layer i
+    N m[64];     // m[i] is the number of nodes of layer i
+    array<T> x;
+    btree_index() : n(0), h(0) { }
+    btree_index(I f, N n) : f(f), n(n), h(0)
+    {
+        // Precondition: $\property{readable\_counted\_range}(f, n)$
+        btree_build(deref(this));
+    }
+};
+
+template<typename I>
+    requires(Readable(I) && RandomAccessIterator(I))
+void btree_build(btree_index<I>& e)
+{
+    // Precondition: $\property{readable\_counted\_range}(e.f, e.n) \wedge e.h = 0$
+    typedef ValueType(I) T;
+    typedef DistanceType(I) N;
+    I f = e.f;
+    N n = e.n;
+    pointer(N) o = e.o;
+    pointer(N) m = e.m;
+    int& h = e.h;
+    array<T>& x = e.x;
+    if (zero(n)) return;
+    const N b = N(btree_node_size<T>());
+    m[0] = (n + b - N(1)) / b;
+    h = 1;
+    while (N(1) < m[h - 1]) {
+        m[h] = (m[h - 1] + b) / successor(b);
+        h = successor(h);
+    }
+    N s(0);
+    for (int i = h - 1; i >= 0; i = predecessor(i)) s = s + m[i] * b;
+    x = array<T>(s + N(cache_line_size), s + N(cache_line_size), source(f));
+    // Skip to the first cache line boundary in $x$
+    N a(0);
+    while (reinterpret_cast<unsigned long long>(begin(x) + a) % cache_line_size != 0 &&
+           a < N(cache_line_size))
+        a = successor(a);
+    if (a == N(cache_line_size)) a = N(0);
+    for (int i = h - 1; i >= 0; i = predecessor(i)) {
+        o[i] = a;
+        a = a + m[i] * b;
+    }
+    T z = source(f + predecessor(n));
+    for (N i(0); i < m[0] * b; i = successor(i))
+        x[o[0] + i] = i < n ? source(f + i) : z;
+    // $w$ is the number of elements of the range below a node of layer
+    // $i - 1$
+    N w = b;
+    for (int i = 1; i < h; i = successor(i)) {
+        for (N k(0); k < m[i]; k = successor(k))
+            for (N j(0); j < b; j = successor(j)) {
+                N p = (k * successor(b) + successor(j)) * w;
+                x[o[i] + k * b + j] = p < n ? source(f + p) : z;
+            }
+        w = w * successor(b);
+    }
+}
+
+template<typename I>
+    requires(Readable(I) && RandomAccessIterator(I))
+DistanceType(I) size(const btree_index<I>& e)
+{
+    return e.n;
+}
+
+template<typename I, typename P>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P))
+DistanceType(I) btree_count(const btree_index<I>& e, int i,
+                            DistanceType(I) k, P p)
+{
+    // Precondition: $0 \leq i < e.h \wedge 0 \leq k < e.m[i]$
+    // Postcondition: the number of elements of node $k$ of layer $i$ not
+    //     satisfying $p$
+    typedef ValueType(I) T;
+    typedef DistanceType(I) N;
+    const int b = btree_node_size<T>();
+    pointer(const T) x = begin(e.x) + (e.o[i] + k * N(b));
+    int c = 0;
+    for (int j = 0; j < b; j = successor(j))
+        c = c + int(!p(x[j]));
+    return N(c);
+}
+
+template<typename I, typename P>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P))
+DistanceType(I) btree_child(const btree_index<I>& e, int i,
+                            DistanceType(I) k, P p)
+{
+    // Precondition: $0 < i < e.h \wedge 0 \leq k < e.m[i]$
+    // Postcondition: the node of layer $i - 1$ to search next; a child
+    //     past the last node of its layer has only copies of the last
+    //     element below it, so the last node is as good
+    typedef DistanceType(I) N;
+    N b = N(btree_node_size<ValueType(I)>());
+    k = k * successor(b) + btree_count(e, i, k, p);
+    N l = predecessor(e.m[predecessor(i)]);
+    return k < l ? k : l;
+}
+
+template<typename I, typename P>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P))
+I btree_leaf(const btree_index<I>& e, DistanceType(I) k, P p)
+{
+    // Precondition: $0 \leq k < e.m[0]$
+    typedef DistanceType(I) N;
+    N b = N(btree_node_size<ValueType(I)>());
+    N r = k * b + btree_count(e, 0, k, p);
+    return e.f + (r < e.n ? r : e.n);
+}
+
+template<typename I, typename P>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        UnaryPredicate(P) && ValueType(I) == Domain(P))
+I partition_point(const btree_index<I>& e, P p)
+{
+    // Precondition: $\func{partitioned\_n}(f, n, p)$ for the range $[f, f + n)$
+    //     of $e$
+    // Postcondition: returns $\func{partition\_point\_n}(f, n, p)$
+    typedef DistanceType(I) N;
+    if (zero(e.n)) return e.f;
+    N k(0);
+    for (int i = predecessor(e.h); i > 0; i = predecessor(i))
+        k = btree_child(e, i, k, p);
+    return btree_leaf(e, k, p);
+}
+
+template<typename I, typename R>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        Relation(R) && ValueType(I) == Domain(R))
+I lower_bound(const btree_index<I>& e, const ValueType(I)& a, R r)
+{
+    // Precondition:
+    // $\property{weak\_ordering(r)} \wedge \property{increasing\_counted\_range}(f, n, r)$
+    // Postcondition: returns $\func{lower\_bound\_n}(f, n, a, r)$
+    lower_bound_predicate<R> p(a, r);
+    return partition_point(e, p);
+}
+
+template<typename I, typename R>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        Relation(R) && ValueType(I) == Domain(R))
+I upper_bound(const btree_index<I>& e, const ValueType(I)& a, R r)
+{
+    // Precondition:
+    // $\property{weak\_ordering(r)} \wedge \property{increasing\_counted\_range}(f, n, r)$
+    // Postcondition: returns $\func{upper\_bound\_n}(f, n, a, r)$
+    upper_bound_predicate<R> p(a, r);
+    return partition_point(e, p);
+}
+
+
+// Batched search
+
+// A single search waits for each of its lines in turn. Searching
+// $\func{btree\_search\_lanes}$ values together, a layer at a time, asks
+// for the next node of every search before reading any of them, so the
+// lines of all the searches are fetched at once
+
+const int btree_search_lanes = 16;
+
+template<typename P, typename I, typename I0, typename O, typename R>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        Readable(I0) && Iterator(I0) && ValueType(I0) == ValueType(I) &&
+        Writable(O) && Iterator(O) && ValueType(O) == I &&
+        Relation(R) && ValueType(I) == Domain(R) &&
+        P == lower_bound_predicate<R> || P == upper_bound_predicate<R>)
+O partition_points_n(const btree_index<I>& e, I0 f, DistanceType(I0) n,
+                     O o, R r)
+{
+    // Precondition: $\property{readable\_counted\_range}(f, n)$
+    // Postcondition: writes $\func{partition\_point}(e, P(a, r))$ for each
+    //     $a$ in $[f, f + n)$
+    typedef ValueType(I) T;
+    typedef DistanceType(I) N;
+    typedef DistanceType(I0) M;
+    const int g = btree_search_lanes;
+    const N b = N(btree_node_size<T>());
+    N k[g];
+    while (!zero(n)) {
+        int l = n < M(g) ? int(n) : g;
+        for (int j = 0; j < l; j = successor(j)) k[j] = N(0);
+        if (zero(e.n)) {
+            for (int j = 0; j < l; j = successor(j)) {
+                sink(o) = e.f;
+                o = successor(o);
+            }
+        } else {
+            for (int i = predecessor(e.h); i > 0; i = predecessor(i)) {
+                I0 q = f;
+                for (int j = 0; j < l; j = successor(j)) {
+                    k[j] = btree_child(e, i, k[j], P(source(q), r));
+                    prefetch(begin(e.x) + (e.o[predecessor(i)] + k[j] * b));
+                    q = successor(q);
+                }
+            }
+            I0 q = f;
+            for (int j = 0; j < l; j = successor(j)) {
+                sink(o) = btree_leaf(e, k[j], P(source(q), r));
+                o = successor(o);
+                q = successor(q);
+            }
+        }
+        f = f + M(l);
+        n = n - M(l);
+    }
+    return o;
+}
+
+template<typename I, typename I0, typename O, typename R>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        Readable(I0) && Iterator(I0) && ValueType(I0) == ValueType(I) &&
+        Writable(O) && Iterator(O) && ValueType(O) == I &&
+        Relation(R) && ValueType(I) == Domain(R))
+O lower_bounds_n(const btree_index<I>& e, I0 f, DistanceType(I0) n, O o, R r)
+{
+    // Precondition: as for $\func{lower\_bound}$ and
+    //     $\property{readable\_counted\_range}(f, n)$
+    // Postcondition: writes $\func{lower\_bound}(e, a, r)$ for each $a$ in
+    //     $[f, f + n)$
+    return partition_points_n< lower_bound_predicate<R> >(e, f, n, o, r);
+}
+
+template<typename I, typename I0, typename O, typename R>
+    requires(Readable(I) && RandomAccessIterator(I) &&
+        Readable(I0) && Iterator(I0) && ValueType(I0) == ValueType(I) &&
+        Writable(O) && Iterator(O) && ValueType(O) == I &&
+        Relation(R) && ValueType(I) == Domain(R))
+O upper_bounds_n(const btree_index<I>& e, I0 f, DistanceType(I0) n, O o, R r)
+{
+    // Precondition: as for $\func{upper\_bound}$ and
+    //     $\property{readable\_counted\_range}(f, n)$
+    // Postcondition: writes $\func{upper\_bound}(e, a, r)$ for each $a$ in
+    //     $[f, f + n)$
+    return partition_points_n< upper_bound_predicate<R> >(e, f, n, o, r);
+}
+
+#endif // EOP_SEARCH
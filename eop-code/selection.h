@@ -0,0 +1,387 @@
+// selection.h
+
+// Copyright (c) 2009 Alexander Stepanov and Paul McJones
+//
+// Permission to use, copy, modify, distribute and sell this software
+// and its documentation for any purpose is hereby granted without
+// fee, provided that the above copyright notice appear in all copies
+// and that both that copyright notice and this permission notice
+// appear in supporting documentation. The authors make no
+// representations about the suitability of this software for any
+// purpose. It is provided "as is" without express or implied
+// warranty.
+
+
+// Order selection networks extending Chapter 4 of
+// Elements of Programming
+// by Alexander Stepanov and Paul McJones
+// Addison-Wesley Professional, 2009
+
+
+#ifndef EOP_SELECTION
+#define EOP_SELECTION
+
+
+#include "intrinsics.h"
+#include "type_functions.h"
+#include "eop.h"
+
+
+// Branch-free order selection
+
+// The order selection procedures of Chapter 4 branch on each comparison,
+// and their stability indices are known at compile time only because
+// each branch is a different instantiation. A network instead moves
+// values between fixed positions with conditional assignments, carrying
+// each value's stability index along with it; comparing lexicographically
+// by value under $r$ and then by index makes the order strict and total,
+// so the network selects the same object as the procedure with stability
+// indices $0, 1, \ldots$. Without branches the same instructions run for
+// every window, and a loop over many windows vectorizes
+
+template<typename R>
+    requires(Relation(R))
+bool precedes_stable(const Domain(R)& x, int ix,
+                     const Domain(R)& y, int iy, R r)
+{
+    // Precondition: $\func{weak\_ordering}(r)$
+    return r(x, y) | (!r(y, x) & (ix < iy));
+}
+
+template<typename R>
+    requires(Relation(R))
+bool precedes_stable_once(const Domain(R)& x, int ix,
+                          const Domain(R)& y, int iy, R r)
+{
+    // Precondition: $\func{weak\_ordering}(r) \wedge ix \neq iy$
+    // Same as $\func{precedes\_stable}$ with one comparison, chosen as in
+    // $\func{compare\_strict\_or\_reflexive}$
+    typedef Domain(R) T;
+    bool s = ix < iy;
+    T u = s ? y : x;
+    T v = s ? x : y;
+    return s != r(u, v);
+}
+
+template<typename R>
+    requires(Relation(R))
+void sort_2_stable(Domain(R)& x, int& ix, Domain(R)& y, int& iy, R r)
+{
+    // Precondition: $\func{weak\_ordering}(r)$
+    // Postcondition: $(x, ix)$ precedes $(y, iy)$
+    typedef Domain(R) T;
+    bool s = precedes_stable_once(y, iy, x, ix, r);
+    T t = s ? y : x;
+    y = s ? x : y;
+    x = t;
+    int it = s ? iy : ix;
+    iy = s ? ix : iy;
+    ix = it;
+}
+
+template<typename R>
+    requires(Relation(R))
+Domain(R) select_1_4_ab_network(const Domain(R)& a, int ia,
+                                const Domain(R)& b, int ib,
+                                Domain(R) c, int ic,
+                                Domain(R) d, int id, R r)
+{
+    // Precondition: $\func{weak\_ordering}(r)$
+    // Precondition: $(a, ia)$ precedes $(b, ib)$
+    // The second is the earlier of the later of $a$, $c$
+    // and the earlier of $b$, $d$
+    typedef Domain(R) T;
+    sort_2_stable(c, ic, d, id, r);
+    bool s = precedes_stable(c, ic, a, ia, r);
+    T x = s ? a : c;
+    int ix = s ? ia : ic;
+    bool t = precedes_stable(d, id, b, ib, r);
+    T y = t ? d : b;
+    int iy = t ? id : ib;
+    return precedes_stable(y, iy, x, ix, r) ? y : x;
+}
+
+template<typename R>
+    requires(Relation(R))
+Domain(R) select_1_4_network(Domain(R) a, Domain(R) b,
+                             Domain(R) c, Domain(R) d, R r)
+{
+    // Precondition: $\func{weak\_ordering}(r)$
+    // Postcondition: returns a copy of $\func{select\_1\_4}<0,1,2,3>(a, b, c, d, r)$
+    int ia(0), ib(1);
+    sort_2_stable(a, ia, b, ib, r);
+    return select_1_4_ab_network(a, ia, b, ib, c, 2, d, 3, r);
+}
+
+template<typename R>
+    requires(Relation(R))
+Domain(R) select_2_5_network(Domain(R) a, Domain(R) b, Domain(R) c,
+                             Domain(R) d, Domain(R) e, R r)
+{
+    // Precondition: $\func{weak\_ordering}(r)$
+    // Postcondition: returns a copy of $\func{select\_2\_5}<0,1,2,3,4>(a, b, c, d, e, r)$
+    // The earlier of the earliest of the pairs $a, b$ and $c, d$ is
+    // preceded by at most one other value, so it is not the median; the
+    // median is the second of the other three values and $e$
+    typedef Domain(R) T;
+    int ia(0), ib(1), ic(2), id(3);
+    sort_2_stable(a, ia, b, ib, r);
+    sort_2_stable(c, ic, d, id, r);
+    bool s = precedes_stable(c, ic, a, ia, r);
+    T x = s ? a : c;
+    int ix = s ? ia : ic;
+    T y = s ? b : d;
+    int iy = s ? ib : id;
+    T z = s ? d : b;
+    int iz = s ? id : ib;
+    return select_1_4_ab_network(x, ix, y, iy, z, iz, e, 4, r);
+}
+
+template<typename R>
+    requires(Relation(R))
+Domain(R) median_5_network(const Domain(R)& a, const Domain(R)& b,
+                           const Domain(R)& c, const Domain(R)& d,
+                           const Domain(R)& e, R r)
+{
+    return select_2_5_network(a, b, c, d, e, r);
+}
+
+
+// Selection over many windows
+
+// Window $i$ consists of the $i$-th elements of the counted ranges
+// $[f_0, n), [f_1, n), \ldots$, and the selected value of each window
+// is written to $[o, n)$. The ranges may overlap: a median filter
+// passes successive iterators into one sequence of samples
+
+template<typename I, typename O, typename R>
+    requires(Readable(I) && Iterator(I) &&
+        Writable(O) && Iterator(O) &&
+        Relation(R) && ValueType(I) == Domain(R) &&
+        ValueType(I) == ValueType(O))
+O select_1_4_n(I f0, I f1, I f2, I f3, DistanceType(I) n, O o, R r)
+{
+    // Precondition: $\func{weak\_ordering}(r)$
+    // Precondition: $\property{not\_overlapped\_forward}$ between $[o, n)$ and each $[f_j, n)$
+    while (count_down(n)) {
+        sink(o) = select_1_4_network(source(f0), source(f1),
+                                     source(f2), source(f3), r);
+        f0 = successor(f0); f1 = successor(f1);
+        f2 = successor(f2); f3 = successor(f3);
+        o = successor(o);
+    }
+    return o;
+}
+
+template<typename I, typename O, typename R>
+    requires(Readable(I) && Iterator(I) &&
+        Writable(O) && Iterator(O) &&
+        Relation(R) && ValueType(I) == Domain(R) &&
+        ValueType(I) == ValueType(O))
+O select_2_5_n(I f0, I f1, I f2, I f3, I f4, DistanceType(I) n, O o, R r)
+{
+    // Precondition: $\func{weak\_ordering}(r)$
+    // Precondition: $\property{not\_overlapped\_forward}$ between $[o, n)$ and each $[f_j, n)$
+    while (count_down(n)) {
+        sink(o) = select_2_5_network(source(f0), source(f1), source(f2),
+                                     source(f3), source(f4), r);
+        f0 = successor(f0); f1 = successor(f1); f2 = successor(f2);
+        f3 = successor(f3); f4 = successor(f4);
+        o = successor(o);
+    }
+    return o;
+}
+
+template<typename I, typename O, typename R>
+    requires(Readable(I) && Iterator(I) &&
+        Writable(O) && Iterator(O) &&
+        Relation(R) && ValueType(I) == Domain(R) &&
+        ValueType(I) == ValueType(O))
+O median_5_n(I f0, I f1, I f2, I f3, I f4, DistanceType(I) n, O o, R r)
+{
+    return select_2_5_n(f0, f1, f2, f3, f4, n, o, r);
+}
+
+template<typename I, typename O, typename R>
+    requires(Readable(I) && ForwardIterator(I) &&
+        Writable(O) && Iterator(O) &&
+        Relation(R) && ValueType(I) == Domain(R) &&
+        ValueType(I) == ValueType(O))
+O median_5_filter_n(I f, DistanceType(I) n, O o, R r)
+{
+    // Precondition: $\func{weak\_ordering}(r) \wedge n \geq 5$
+    // Postcondition: writes the median of $[f + i, f + i + 5)$ for $0 \leq i \leq n - 5$
+    I f1 = successor(f);
+    I f2 = successor(f1);
+    I f3 = successor(f2);
+    I f4 = successor(f3);
+    return select_2_5_n(f, f1, f2, f3, f4, n - 4, o, r);
+}
+
+
+// Generated selection networks
+
+// $\func{select\_k\_n}<k, n>$ extends the selection networks to any $k$
+// and any $n \leq \func{selection\_network\_max}$ known at compile time,
+// such as the third of 7 or the median of 9. Its comparators are
+// generated at compile time: Batcher's odd-even merge sort of $n$ wires
+// is pruned, from its last comparator to its first, of each comparator
+// without which wire $k$ still receives the $k$-th value. By the 0-1
+// principle it is enough to try the $2^n$ sequences of zeros and ones,
+// which are run 64 at a time in the bits of a word. The comparators move
+// copies of the values along with their stability indices and make one
+// comparison each, so the result agrees with $\func{select\_1\_4}<0,1,2,3>$
+// and $\func{select\_2\_5}<0,1,2,3,4>$. A network makes more comparisons
+// than the best procedure that branches: 19 rather than 14 for the median
+// of 9. Its comparisons do not depend on the values, which suits cheap
+// comparisons and many windows
+
+const int selection_network_max = 12;
+const int selection_network_capacity = 42; // Batcher's sort of 12 wires
+
+struct comparator_network
+{
+    int m;                     // number of comparators
+    int a[selection_network_capacity];
+    int b[selection_network_capacity];
+    // comparator $i$ puts the earlier of wires $a[i] < b[i]$ on $a[i]$
+};
+
+constexpr comparator_network odd_even_merge_sort_network(int n)
+{
+    // Precondition: $0 < n \leq \func{selection\_network\_max}$
+    comparator_network s = {};
+    for (int p = 1; p < n; p = 2 * p)
+        for (int k = p; k > 0; k = k / 2)
+            for (int j = k % p; j < n - k; j = j + 2 * k)
+                for (int i = 0; i < k && i < n - j - k; i = i + 1)
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        s.a[s.m] = i + j;
+                        s.b[s.m] = i + j + k;
+                        s.m = s.m + 1;
+                    }
+    return s;
+}
+
+constexpr unsigned long long zero_one_output(const comparator_network& s,
+                                             int skip, int k, int q)
+{
+    // Bit $t$ of the result is wire $k$ after the comparators of $s$ other
+    // than $skip$, given the sequence whose wire $w$ is bit $w$ of $64 q + t$
+    const unsigned long long p[6] = {
+        0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull,
+        0xff00ff00ff00ff00ull, 0xffff0000ffff0000ull, 0xffffffff00000000ull };
+    unsigned long long x[selection_network_max] = {};
+    for (int w = 0; w < selection_network_max; w = w + 1)
+        x[w] = w < 6 ? p[w] : (q >> (w - 6)) % 2 != 0 ? ~0ull : 0ull;
+    for (int i = 0; i < s.m; i = i + 1) {
+        if (i == skip) continue;
+        unsigned long long u = x[s.a[i]];
+        x[s.a[i]] = u & x[s.b[i]];
+        x[s.b[i]] = u | x[s.b[i]];
+    }
+    return x[k];
+}
+
+constexpr comparator_network generate_selection_network(int k, int n)
+{
+    // Precondition: $0 \leq k < n \leq \func{selection\_network\_max}$
+    comparator_network s = odd_even_merge_sort_network(n);
+    int words = n > 6 ? 1 << (n - 6) : 1;
+    for (int c = s.m - 1; c >= 0; c = c - 1) {
+        bool needed = false;
+        for (int q = 0; q < words && !needed; q = q + 1)
+            needed = zero_one_output(s, c, k, q) != zero_one_output(s, -1, k, q);
+        if (needed) continue;
+        s.m = s.m - 1;
+        for (int i = c; i < s.m; i = i + 1) {
+            s.a[i] = s.a[i + 1];
+            s.b[i] = s.b[i + 1];
+        }
+    }
+    return s;
+}
+
+constexpr bool selection_wire_live(const comparator_network& s, int c,
+                                   int w, int k)
+{
+    // Whether wire $w$ is read after comparator $c$ of $s$ selecting wire $k$
+    for (int i = c + 1; i < s.m; i = i + 1)
+        if (s.a[i] == w || s.b[i] == w) return true;
+    return w == k;
+}
+
+template<int k, int n>
+struct selection_network
+{
+    static constexpr comparator_network value = generate_selection_network(k, n);
+};
+
+template<int k, int n>
+constexpr comparator_network selection_network<k, n>::value;
+
+template<int k, int n, int i,
+         bool done = i == selection_network<k, n>::value.m>
+struct select_k_n_comparators
+{
+    // Applies comparators $i, i + 1, \ldots$ of $\func{selection\_network}<k, n>$,
+    // moving only the outputs that are read later
+    static const int a = selection_network<k, n>::value.a[i];
+    static const int b = selection_network<k, n>::value.b[i];
+    static const bool earlier =
+        selection_wire_live(selection_network<k, n>::value, i, a, k);
+    static const bool later =
+        selection_wire_live(selection_network<k, n>::value, i, b, k);
+    template<typename R>
+        requires(Relation(R))
+    static void apply(pointer(Domain(R)) x, pointer(int) ix, R r)
+    {
+        typedef Domain(R) T;
+        bool s = precedes_stable_once(x[b], ix[b], x[a], ix[a], r);
+        T t = s ? x[b] : x[a];
+        int it = s ? ix[b] : ix[a];
+        if (later) {
+            x[b] = s ? x[a] : x[b];
+            ix[b] = s ? ix[a] : ix[b];
+        }
+        if (earlier) {
+            x[a] = t;
+            ix[a] = it;
+        }
+        select_k_n_comparators<k, n, i + 1>::apply(x, ix, r);
+    }
+};
+
+template<int k, int n, int i>
+struct select_k_n_comparators<k, n, i, true>
+{
+    template<typename R>
+    static void apply(pointer(Domain(R)), pointer(int), R) { }
+};
+
+template<int k, int n, typename I, typename R>
+    requires(Readable(I) && ForwardIterator(I) &&
+        Relation(R) && ValueType(I) == Domain(R))
+I select_k_n(I f, R r)
+{
+    // Precondition: $\func{readable\_bounded\_range}(f, n)$
+    // Precondition: $0 \leq k < n \leq \func{selection\_network\_max}$
+    // Precondition: $\func{weak\_ordering}(r)$
+    // Returns the $k$-th element of $[f, f + n)$ in the stable order
+    // The network permutes copies of the values with their indices, which
+    // then select among the iterators
+    typedef ValueType(I) T;
+    I g[n];
+    T x[n];
+    int ix[n];
+    for (int i = 0; i < n; i = successor(i)) {
+        g[i] = f;
+        x[i] = source(f);
+        ix[i] = i;
+        f = successor(f);
+    }
+    select_k_n_comparators<k, n, 0>::apply(x, ix, r);
+    return g[ix[k]];
+}
+
+#endif // EOP_SELECTION
@@ -18,7 +18,7 @@
 // Addison-Wesley Professional, 2009
 
 
-// To do: move rational, polynomial to eop.h ?
+// To do: move rational to eop.h ?
 
 
 #ifndef EOP_TESTS
@@ -28,6 +28,16 @@
 #include "intrinsics.h"
 #include "type_functions.h"
 #include "eop.h"
+#include "orbits.h"
+#include "powers.h"
+#include "multiprecision.h"
+#include "matrices.h"
+#include "selection.h"
+#include "euclidean.h"
+#include "rationals.h"
+#include "polynomials.h"
+#include "search.h"
+#include "drivers.h" // table_transformation
 #include "print.h"
 #include "assertions.h"
 
@@ -184,6 +194,28 @@ template<typename T>
     requires(MultiplicativeSemigroup(T))
 struct input_type<times<T>, 0> { typedef T type; };
 
+void test_instrumented()
+{
+    typedef instrumented<int> T;
+    typedef instrumented_base B;
+    T x0(0);
+    T x1(1);
+    concept_Regular(x0);
+    concept_TotallyOrdered(x0, x1);
+    T a[10];
+    for (int i = 0; i < 10; i = successor(i)) a[i].value = i;
+    B::initialize(10);
+    reverse_bidirectional(a, a + 10);
+    pointer(double) c = B::counts();
+    Assert(c[B::n] == 10 && c[B::copy_construction] == 5 &&
+           c[B::assignment] == 10 && c[B::destruction] == 5 &&
+           c[B::comparison] == 0 && c[B::construction] == 0);
+    Assert(a[0].value == 9 && a[9].value == 0);
+    B::initialize(2);
+    Assert(a[1] < a[0] && !(a[0] == a[1]));
+    Assert(c[B::comparison] == 1 && c[B::equality] == 1);
+}
+
 void test_ch_1()
 {
     print("  Chapter 1\n");
@@ -206,6 +238,7 @@ void test_ch_1()
     Assert(square(3, times<int>()) == 9);
 
     test_tuples();
+    test_instrumented();
 }
 
 
@@ -354,6 +387,7 @@ void algorithms_orbit(Domain(F) x, DistanceType(F) h, DistanceType(F) c)
     if (!zero(c))
         Assert(y == connection_point_nonterminating_orbit(x, f));
     triple<unsigned, unsigned, int> t = orbit_structure(x, f, f.p);
+    Assert(orbit_structure_teleporting(x, f, f.p) == t);
     if (zero(c)) { // terminating
         Assert(t.m0 == h);
         Assert(zero(t.m1));
@@ -412,6 +446,183 @@ struct distance_type< hf<N> >
     typedef N type;
 };
 
+struct square_plus_one // transformation on $[0, m)$
+{
+    int m;
+    square_plus_one(int m) : m(m) { }
+    int operator()(int x)
+    {
+        return (x * x + 1) % m;
+    }
+};
+
+template<>
+struct input_type<square_plus_one, 0>
+{
+    typedef int type;
+};
+
+template<>
+struct codomain_type<square_plus_one>
+{
+    typedef int type;
+};
+
+template<>
+struct distance_type<square_plus_one>
+{
+    typedef unsigned type;
+};
+
+void algorithm_orbit_structure_distinguished_n(int m, int k, int threads)
+{
+    typedef triple<unsigned, unsigned, int> T;
+    square_plus_one f(m);
+    gen_orbit_predicate<int, unsigned> p(0, 0u, unsigned(m));
+    array<int> x(m, m, 0);
+    array<T> t(m, m, T(0u, 0u, 0));
+    for (int i = 0; i < m; ++i) x[i] = i;
+    orbit_structure_distinguished_n(begin(x), m, begin(t), f, p, k, threads);
+    for (int i = 0; i < m; ++i)
+        Assert(t[i] == orbit_structure(i, f, p));
+}
+
+template<typename N>
+    requires(Integer(N))
+void algorithm_orbit_structures_table(N n, N a, N b, N c, N m)
+{
+    // Table of $x \mapsto (a x^2 + b x + c) \bmod m$; values $\geq n$ terminate
+    typedef pointer(N) I;
+    typedef triple<N, N, N> T;
+    array<N> f(n, n, N(0));
+    for (N x(0); x < n; x = successor(x)) f[x] = (a * x * x + b * x + c) % m;
+    table_transformation<I> g(begin(f), n);
+    table_transformation_definition_space_predicate<I> p(g);
+    for (int threads = 1; threads < 5; threads = successor(threads)) {
+        array<T> t(n, n, T(N(0), N(0), N(0)));
+        orbit_structures_table(begin(f), n, begin(t), threads);
+        for (N x(0); x < n; x = successor(x))
+            Assert(t[x] == orbit_structure(x, g, p));
+    }
+}
+
+template<typename F>
+    requires(Transformation(F))
+void algorithms_composable_transformation(Domain(F) x, F f)
+{
+    typedef DistanceType(F) N;
+    Domain(F) y = x;
+    for (N n(0); n < N(300); n = successor(n)) {
+        Assert(power_unary(x, n, f) == y);
+        Assert(power_unary(x, n, f) == power_unary(x, n, f, transformation_tag()));
+        Domain(F) z = power_unary(y, n, f);
+        if (power_unary(y, N(4096), f) == power_unary(z, N(4096), f)) // they converge
+            Assert(convergent_point(y, z, f) ==
+                   convergent_point(y, z, f, transformation_tag()));
+        y = f(y);
+    }
+    Assert(power_unary(power_unary(x, N(1000000), f), N(123456), f) ==
+           power_unary(x, N(1123456), f));
+}
+
+template<typename F>
+    requires(Transformation(F) && Integer(Domain(F)))
+void algorithm_orbit_structure_parallel(Domain(F) x, F f)
+{
+    // Precondition: the orbit of $x$ under $f$ is not terminating
+    triple<DistanceType(F), DistanceType(F), Domain(F)> t =
+        orbit_structure(x, f, always_defined<Domain(F)>);
+    for (int k = 0; k < 5; k = k + 2)
+        for (int threads = 1; threads < 5; threads = threads + 2)
+            Assert(orbit_structure_parallel(x, f, k, threads) == t);
+}
+
+template<int k, typename T>
+    requires(Integer(T))
+void algorithm_orbit_structure_lanes(T a, T b, T m, T n)
+{
+    // Starting points $[0, n)$ of $x \mapsto (a x + b) \bmod m$
+    typedef DistanceType(T) N;
+    typedef triple<N, N, T> R;
+    affine_transformation<T> f(a, b, m);
+    array<T> x(n, n, T(0));
+    array<R> t(n, n, R(N(0), N(0), T(0)));
+    iota(n, begin(x));
+    orbit_structure_lanes<k>(begin(x), n, begin(t), f);
+    for (T i(0); i < n; i = successor(i))
+        Assert(t[i] == orbit_structure_nonterminating_orbit(x[i], f));
+}
+
+template<typename F>
+    requires(Transformation(F))
+void algorithm_orbit_structure_checkpointed(F f, Domain(F) x, DistanceType(F) n,
+                                            DistanceType(F) interval)
+{
+    // Precondition: the collision point of $x$ is at least $f^{3 n + 1}(x)$
+    typedef Domain(F) T;
+    typedef DistanceType(F) N;
+    typedef pointer(N) I;
+    const pointer(char) file = "eop_test_checkpoint";
+    N calls_fresh(0);
+    N calls(0);
+    instrumented_transformation<F, I> g(f, &calls_fresh);
+    instrumented_transformation<F, I> h(f, &calls);
+    T y = collision_point_nonterminating_orbit(x, f);
+    remove(file);
+    Assert(collision_point_checkpointed(x, g, always_defined<T>, file, interval) == y);
+    Assert(collision_point_checkpointed(x, h, always_defined<T>, file, interval) == y);
+    Assert(zero(calls)); // memoized
+    orbit_checkpoint<T, N> c(checkpoint_collision_point, transformation_key(f),
+                             x, x, power_unary(x, n, f),
+                             power_unary(x, twice(n) + N(1), f), n);
+    write_checkpoint(file, c);
+    Assert(collision_point_checkpointed(x, h, always_defined<T>, file, interval) == y);
+    Assert(calls == calls_fresh - N(3) * n - N(1)); // resumed
+    c.x0 = f(x);
+    write_checkpoint(file, c);
+    calls = N(0);
+    Assert(collision_point_checkpointed(x, h, always_defined<T>, file, interval) == y);
+    Assert(calls == calls_fresh); // another argument's checkpoint is ignored
+    c.x0 = x;
+    c.key = key_combine(c.key, 1ull);
+    write_checkpoint(file, c);
+    calls = N(0);
+    Assert(collision_point_checkpointed(x, h, always_defined<T>, file, interval) == y);
+    Assert(calls == calls_fresh); // another transformation's checkpoint is ignored
+    remove(file);
+    Assert(orbit_structure_checkpointed(x, f, always_defined<T>, file, interval) ==
+           orbit_structure_nonterminating_orbit(x, f));
+    Assert(orbit_structure_checkpointed(x, f, always_defined<T>, file, interval) ==
+           orbit_structure_nonterminating_orbit(x, f));
+    remove_orbit_checkpoints(file);
+    for (unsigned h = 0u; h < 20u; h = successor(h))
+        for (unsigned c = 0u; c < 20u; c = successor(c)) {
+            gen_orbit<int, unsigned> f(0, h, c);
+            Assert(orbit_structure_checkpointed(0, f, f.p, file, 3u) == orbit_structure(0, f, f.p));
+            remove_orbit_checkpoints(file);
+        }
+}
+
+void algorithm_orbit_checkpoint_without_key()
+{
+    // Transformations without a $\func{transformation\_key}$ on the same
+    // domain and starting point must not resume from each other's record
+    typedef additive_congruential_transformation<int> F;
+    const pointer(char) file = "eop_test_checkpoint";
+    F f(1000, 3);
+    F g(999, 3);
+    Assert(collision_point_nonterminating_orbit(1, f) !=
+           collision_point_nonterminating_orbit(1, g));
+    remove(file);
+    Assert(collision_point_checkpointed(1, f, always_defined<int>, file, 7) ==
+           collision_point_nonterminating_orbit(1, f));
+    Assert(collision_point_checkpointed(1, g, always_defined<int>, file, 7) ==
+           collision_point_nonterminating_orbit(1, g));
+    pointer(FILE) s = fopen(file, "rb");
+    Assert(s == 0); // nothing was saved
+    remove(file);
+}
+
 void test_ch_2()
 {
     print("  Chapter 2\n");
@@ -444,10 +655,74 @@ void test_ch_2()
     algorithms_orbit< gen_orbit<int, unsigned> >(0, 2u, 11u);
     algorithms_orbit< gen_orbit<int, unsigned> >(7, 97u, 17u);
     algorithms_orbit< gen_orbit<int, unsigned> >(0, 4u, 2u);
+    algorithms_orbit< gen_orbit<int, unsigned> >(0, 3u, 1u);
 
     // Terminating
     algorithms_orbit< gen_orbit<int, unsigned> >(0, 101u, 0u);
 
+    for (unsigned h = 0u; h < 40u; h = successor(h))
+        for (unsigned c = 0u; c < 40u; c = successor(c)) {
+            gen_orbit<int, unsigned> f(0, h, c);
+            Assert(orbit_structure_teleporting(0, f, f.p) == orbit_structure(0, f, f.p));
+            for (int k = 0; k < 4; ++k)
+                Assert(orbit_structure_distinguished(0, f, f.p, k) == orbit_structure(0, f, f.p));
+        }
+
+    algorithm_orbit_structure_distinguished_n(1000, 0, 1);
+    algorithm_orbit_structure_distinguished_n(1000, 3, 1);
+    algorithm_orbit_structure_distinguished_n(1000, 3, 4);
+    algorithm_orbit_structure_distinguished_n(30011, 4, 4);
+
+    algorithms_composable_transformation(3, affine_transformation<int>(6, 5, 1024));
+    algorithms_composable_transformation(7, affine_transformation<int>(0, 5, 1024));
+    algorithms_composable_transformation(7, affine_transformation<int>(1, 0, 1));
+    algorithms_composable_transformation(100, affine_transformation<int>(1000, 37, 1001));
+    algorithms_composable_transformation(5, affine_transformation<int>(2000000000, 1999999999, 2147483647));
+    algorithms_composable_transformation(17, additive_congruential_transformation<int>(1000, 7));
+    algorithms_composable_transformation(lehmer_1949().x0, lehmer_1949());
+
+    algorithm_orbit_structure_parallel(3, affine_transformation<int>(6, 5, 1024));
+    algorithm_orbit_structure_parallel(7, affine_transformation<int>(0, 5, 1024));
+    algorithm_orbit_structure_parallel(0, affine_transformation<int>(1, 0, 1));
+    algorithm_orbit_structure_parallel(100, affine_transformation<int>(1000, 37, 1001));
+    algorithm_orbit_structure_parallel(5, affine_transformation<int>(12, 7, 100000));
+    algorithm_orbit_structure_parallel(17, additive_congruential_transformation<int>(1000, 7));
+    algorithm_orbit_structure_parallel(1ll, LCG(1ll << 16, 1664525ll, 1013904223ll, 1ll, "small"));
+    {
+        // Lehmer 1949 is circular with $c = 5882352$
+        LCG f = lehmer_1949();
+        Assert(power_unary(f.x0, 5882352ull, f) == f.x0);
+        Assert(power_unary(f.x0, 5882352ull << 20, f) == f.x0);
+        Assert(power_unary(f.x0, 5882353ull << 20, f) == power_unary(f.x0, 1ull << 20, f));
+        Assert(convergent_point_guarded(f.x0, f(f.x0), f(f(f.x0)), f) == f(f.x0));
+        Assert(orbit_structure_parallel(f.x0, f, 10, 4) ==
+               triple<DistanceType(LCG), DistanceType(LCG), LCG::T>(0ull, 5882351ull, f.x0));
+    }
+
+    algorithm_orbit_structure_lanes<1>(21, 7, 1000, 1000);
+    algorithm_orbit_structure_lanes<4>(21, 7, 1000, 1000);
+    algorithm_orbit_structure_lanes<8>(21, 7, 1000, 1000);
+    algorithm_orbit_structure_lanes<8>(6, 5, 1024, 1024);
+    algorithm_orbit_structure_lanes<8>(3, 1, 10007, 300);
+    algorithm_orbit_structure_lanes<8>(0, 0, 1, 1);
+    algorithm_orbit_structure_lanes<8>(2147483646, 12345, 2147483647, 100);
+    algorithm_orbit_structure_lanes<4>(3037000498ll, 99ll, 3037000499ll, 100ll);
+    algorithm_orbit_structure_lanes<4>(1ll << 17, 12345ll, 1ll << 34, 100ll);
+    algorithm_orbit_structure_lanes<4>(21ll, 7ll, 1000ll, 3ll);
+
+    algorithm_orbit_structure_checkpointed(affine_transformation<int>(21, 7, 1000), 3, 10, 7);
+    algorithm_orbit_structure_checkpointed(lehmer_1949(), lehmer_1949().x0, 1000000ull, 1ull << 20);
+    algorithm_orbit_checkpoint_without_key();
+
+    typedef DistanceType(pointer(int)) N;
+    algorithm_orbit_structures_table<N>(1, 0, 0, 0, 1);
+    algorithm_orbit_structures_table<N>(1, 0, 0, 1, 2);
+    algorithm_orbit_structures_table<N>(1000, 1, 0, 1, 1000);
+    algorithm_orbit_structures_table<N>(1000, 3, 0, 7, 1100);
+    algorithm_orbit_structures_table<N>(1000, 0, 3, 1, 1000);
+    algorithm_orbit_structures_table<N>(1000, 0, 1, 1, 1001);
+    algorithm_orbit_structures_table<N>(4099, 5, 2, 1, 4099);
+
     Assert(convergent_point_guarded(1024, 64, 1, hf<int>()) == 64);
     Assert(convergent_point_guarded(1025, 65, 1, hf<int>()) == 32);
     Assert(convergent_point_guarded(64, 1024, 1, hf<int>()) == 64);
@@ -554,6 +829,187 @@ void concept_Integer(I n)
     Assert(be != bo);
 }
 
+template<int n>
+void algorithm_power_chain()
+{
+    typedef multiplies<unsigned> Op;
+    typedef instrumented_operation<Op, pointer(int)> Op_counted;
+    int c0(0);
+    int c1(0);
+    unsigned a(3u);
+    Assert(power<n>(a, Op_counted(Op(), &c0)) == power(a, n, Op_counted(Op(), &c1)));
+    Assert(c0 == addition_chain<n>::length);
+    Assert(c0 <= c1);
+    Assert(power_accumulate_positive<n>(5u, a, Op()) ==
+           power_accumulate_positive(5u, a, n, Op()));
+}
+
+template<typename I>
+    requires(Integer(I))
+void algorithm_power_windowed(I n)
+{
+    // Checks all exponents up to $n$, or $n$ alone if it is large
+    typedef multiplies<unsigned> Op;
+    typedef instrumented_operation<Op, pointer(int)> Op_counted;
+    I i = n < I(4096) ? I(1) : n;
+    while (true) {
+        array<bool> b;
+        int l = power_bits(i, b);
+        int c0(0);
+        unsigned a = power(3u, i, Op_counted(Op(), &c0));
+        for (int k = 1; k < 7; k = successor(k)) {
+            int c1(0);
+            int c2(0);
+            Assert(power_k_ary(3u, i, Op_counted(Op(), &c1), k) == a);
+            Assert(power_sliding_window(3u, i, Op_counted(Op(), &c2), k) == a);
+            Assert(c1 == power_k_ary_operations(b, l, k));
+            Assert(c2 == power_sliding_window_operations(b, l, k));
+        }
+        int c1(0);
+        int c2(0);
+        Assert(power_k_ary(3u, i, Op_counted(Op(), &c1)) == a);
+        Assert(power_sliding_window(3u, i, Op_counted(Op(), &c2)) == a);
+        Assert(c1 <= c0 && c2 <= c0);
+        if (i == n) return;
+        i = successor(i);
+    }
+}
+
+void algorithm_big_integer()
+{
+    typedef big_integer I;
+    concept_Integer(I(7));
+    Assert(I(-7) / I(2) == I(-3) && I(-7) % I(2) == I(-1));
+    Assert(I(7) / I(-2) == I(-3) && I(7) % I(-2) == I(1));
+    Assert(predecessor(I(0)) == I(-1) && successor(I(-1)) == I(0));
+    Assert(I("-18446744073709551616") == -binary_scale_up_nonnegative(I(1), 64));
+    Assert(half_nonnegative(I("36893488147419103234")) == I("18446744073709551617"));
+    Assert(fibonacci(I(100)) == I("354224848179261915075"));
+    Assert(fibonacci(I(93)) == fibonacci(I(92)) + fibonacci(I(91)));
+
+    // Karatsuba against schoolbook multiplication
+    I a = power(I(3), 20000, multiplies<I>()); // 497 limbs
+    I b = power(I(7), 9000, multiplies<I>());  // 395 limbs
+    I c = power(I(5), 1000, multiplies<I>());  // 37 limbs
+    array<limb> r0(a.n + b.n, a.n + b.n, limb(0));
+    array<limb> r1(a.n + b.n, a.n + b.n, limb(0));
+    limbs_multiply(a.d, a.n, b.d, b.n, begin(r0));
+    limbs_multiply_schoolbook(a.d, a.n, b.d, b.n, begin(r1));
+    Assert(r0 == r1);
+    Assert(a * b / b == a && (a * b + c) % b == c && a * c / c == a);
+    Assert((a * b - c) / a == predecessor(b));
+    Assert(-a * b == a * -b && -a * -b == a * b);
+
+    // $F_{2n} = F_n (2 F_{n+1} - F_n)$
+    I n(30000);
+    I f = fibonacci(n);
+    Assert(fibonacci(twice(n)) == f * (twice(fibonacci(successor(n))) - f));
+}
+
+void algorithm_multiplies_modulo(limb m)
+{
+    // Precondition: $m > 0$
+    multiplies_modulo_wide op0(m);
+    multiplies_modulo_barrett op1(m);
+    limb x[] = { 0ull, 1ull, 2ull, 3ull, 12345ull, m / 2ull, m - 2ull, m - 1ull,
+                 0x123456789abcdefull % m, ~0ull % m };
+    for (int i = 0; i < 10; i = successor(i))
+        for (int j = 0; j < 10; j = successor(j)) {
+            limb a = x[i] % m;
+            limb b = x[j] % m;
+            Assert(op1(a, b) == op0(a, b));
+            Assert(op1(a, ~b) == op0(a, ~b));
+            if (odd(m) && m < (1ull << 63)) {
+                multiplies_modulo_montgomery op2(m);
+                Assert(op2.from(op2(op2.to(a), op2.to(b))) == op0(a, b));
+                Assert(op2.from(op2.to(a)) == a);
+            }
+        }
+    limb a = 0x123456789abcdefull % m;
+    limb n[] = { 1ull, 2ull, 3ull, 1000ull, m - 1ull, ~0ull };
+    for (int i = 0; i < 6; i = successor(i)) {
+        if (zero(n[i])) continue;
+        limb p = power(a, n[i], op0);
+        Assert(power(a, n[i], op1) == p);
+        if (odd(m) && m < (1ull << 63)) Assert(power_montgomery(a, n[i], m) == p);
+    }
+}
+
+template<typename S, int n>
+    requires(Semiring(S))
+void algorithm_matrix(int k)
+{
+    // Precondition: $n = 0 \vee k = n$
+    typedef matrix<S, n> M;
+    typedef typename S::value_type T;
+    M a(k);
+    M b(k);
+    unsigned x = 12345u;
+    for (int i = 0; i < k; i = successor(i))
+        for (int j = 0; j < k; j = successor(j)) {
+            x = x * 1103515245u + 12345u;
+            a(i, j) = T((x >> 16) % 7u);
+            x = x * 1103515245u + 12345u;
+            b(i, j) = T((x >> 16) % 5u);
+        }
+    M c(k);
+    matrix_multiply_unblocked<S>(a.a, b.a, c.a, k);
+    Assert(a * b == c);
+    Assert(a * identity_matrix<S, n>(k) == a);
+    Assert(identity_matrix<S, n>(k) * b == b);
+    M d = a;
+    Assert(d == a);
+    Assert(power(a, 3, multiplies<M>()) == a * (a * a));
+}
+
+void algorithm_matrix_power()
+{
+    // tests power with matrices over each semiring
+    typedef long long N;
+    {
+        // Fibonacci numbers from the powers of $[\begin{smallmatrix} 1 & 1 \\ 1 & 0 \end{smallmatrix}]$
+        typedef matrix<arithmetic_semiring<N>, 2> M;
+        M f;
+        f(0, 0) = N(1); f(0, 1) = N(1); f(1, 0) = N(1);
+        for (int i = 1; i < 90; i = successor(i))
+            Assert(power(f, i, multiplies<M>())(0, 1) == fibonacci<N>(i));
+    }
+    {
+        // Shortest paths agree with Floyd-Warshall
+        typedef tropical_semiring<N> S;
+        typedef matrix<S, 0> M;
+        int k = 40;
+        M w = identity_matrix<S, 0>(k);
+        unsigned x = 1u;
+        for (int i = 0; i < 4 * k; i = successor(i)) {
+            x = x * 1103515245u + 12345u;
+            int u = int((x >> 16) % unsigned(k));
+            x = x * 1103515245u + 12345u;
+            int v = int((x >> 16) % unsigned(k));
+            x = x * 1103515245u + 12345u;
+            if (u != v) w(u, v) = S::add(w(u, v), N((x >> 16) % 100u));
+        }
+        M d = w;
+        for (int h = 0; h < k; h = successor(h))
+            for (int i = 0; i < k; i = successor(i))
+                for (int j = 0; j < k; j = successor(j))
+                    d(i, j) = S::add(d(i, j), S::multiply(d(i, h), d(h, j)));
+        Assert(power(w, k - 1, multiplies<M>()) == d);
+        Assert(power(w, 3 * k, multiplies<M>()) == d);
+    }
+    {
+        // A cycle of length $k$ returns after $k$ steps and not before
+        typedef matrix<boolean_semiring, 0> M;
+        int k = 97;
+        M c(k);
+        for (int i = 0; i < k; i = successor(i)) c(i, (i + 1) % k) = true;
+        Assert(power(c, k, multiplies<M>()) == identity_matrix<boolean_semiring, 0>(k));
+        Assert(power(c, 5 * k, multiplies<M>()) == identity_matrix<boolean_semiring, 0>(k));
+        Assert(!(power(c, k - 1, multiplies<M>()) == identity_matrix<boolean_semiring, 0>(k)));
+        Assert(power(c, k + 3, multiplies<M>())(5, 8));
+    }
+}
+
 void test_ch_3()
 {
     print("  Chapter 3\n");
@@ -585,6 +1041,36 @@ void test_ch_3()
     algorithm_power(power<int, int (*)(int, int)>);
     algorithm_power_with_identity(power<int, int (*)(int, int)>);
 
+    algorithm_power(power_k_ary<int, int (*)(int, int)>);
+    algorithm_power(power_sliding_window<int, int (*)(int, int)>);
+    algorithm_power_accumulate(power_accumulate_sliding_window<int, int (*)(int, int)>);
+    algorithm_power_windowed<unsigned>(2000u);
+    algorithm_power_windowed<unsigned long long>(0xdeadbeefcafebabeull);
+    algorithm_power_windowed<unsigned long long>(0x8000000000000001ull);
+    algorithm_power_windowed<unsigned long long>(0xffffffffffffffffull);
+
+    Assert(power<10>(2, times_int) == 1024);
+    algorithm_power_chain<1>();
+    algorithm_power_chain<2>();
+    algorithm_power_chain<3>();
+    algorithm_power_chain<5>();
+    algorithm_power_chain<7>();
+    algorithm_power_chain<15>(); // 5 operations rather than 6
+    algorithm_power_chain<16>();
+    algorithm_power_chain<23>();
+    algorithm_power_chain<31>();
+    algorithm_power_chain<33>();
+    algorithm_power_chain<63>();
+    algorithm_power_chain<127>();
+    algorithm_power_chain<191>();
+    algorithm_power_chain<255>();
+    algorithm_power_chain<511>();
+    algorithm_power_chain<1000>();
+    algorithm_power_chain<1023>();
+    algorithm_power_chain<1024>();
+    Assert(addition_chain<15>::length == 5);
+    Assert(addition_chain<1023>::length < 18);
+
     typedef long long N;
     typedef pair<N, N> Fib;
 
@@ -597,6 +1083,41 @@ void test_ch_3()
     Assert(f21.m0 == 10946 && f21.m1 == 6765);
     Assert(fibonacci<N>(10) == N(55));
     Assert(fibonacci<N>(20) == N(6765));
+
+    algorithm_big_integer();
+
+    algorithm_multiplies_modulo(1ull);
+    algorithm_multiplies_modulo(2ull);
+    algorithm_multiplies_modulo(3ull);
+    algorithm_multiplies_modulo(1000000007ull);
+    algorithm_multiplies_modulo(4294967291ull);
+    algorithm_multiplies_modulo(576460752303423488ull); // NAG
+    algorithm_multiplies_modulo(999999999989ull);       // MAPLE
+    algorithm_multiplies_modulo((1ull << 61) - 1ull);
+    algorithm_multiplies_modulo((1ull << 63) - 25ull);
+    algorithm_multiplies_modulo(~0ull);
+    algorithm_multiplies_modulo(~0ull - 58ull);
+    algorithm_matrix< arithmetic_semiring<long long>, 0 >(1);
+    algorithm_matrix< arithmetic_semiring<long long>, 0 >(70);
+    algorithm_matrix< arithmetic_semiring<double>, 0 >(129);
+    algorithm_matrix< arithmetic_semiring<big_integer>, 0 >(9);
+    algorithm_matrix< arithmetic_semiring<int>, 67 >(67);
+    algorithm_matrix< tropical_semiring<int>, 0 >(70);
+    algorithm_matrix< tropical_semiring<double>, 5 >(5);
+    algorithm_matrix< boolean_semiring, 0 >(100);
+    algorithm_matrix_power();
+    // Fermat: $a^{p-1} = 1$ for the prime $p = 2^{61}-1$
+    Assert(power_montgomery(3ull, (1ull << 61) - 2ull, (1ull << 61) - 1ull) == 1ull);
+    {
+        // The 128-bit LCG agrees with stepping $x \mapsto (a x + b) \bmod m$ exactly
+        LCG f(999999999989ll, 427619669081ll, 0ll, 1ll, "MAPLE");
+        affine_transformation<long long> g(427619669081ll, 0ll, 999999999989ll);
+        long long x = f.x0;
+        for (int i = 0; i < 1000; i = successor(i)) {
+            Assert(f(x) == g(x));
+            x = f(x);
+        }
+    }
 };
 
 
@@ -981,6 +1502,120 @@ void algorithm_median_5()
 
 typedef pair<int, int> int_pair;
 
+bool less_int(int x, int y) { return x < y; }
+
+void algorithm_select_network()
+{
+    // Exhaustive over keys in $[0, 5)$; the payload is the stability index
+    print("    select_1_4_network, select_2_5_network\n");
+    typedef pair<int, int> P;
+    typedef less_first<int, int> R;
+    const int n = 5 * 5 * 5 * 5 * 5;
+    P w[5][n];
+    for (int i = 0; i < n; i = successor(i)) {
+        int k = i;
+        for (int j = 0; j < 5; j = successor(j)) {
+            w[j][i] = P(k % 5, j);
+            k = k / 5;
+        }
+        Assert(select_1_4_network(w[0][i], w[1][i], w[2][i], w[3][i], R()) ==
+               select_1_4<0,1,2,3>(w[0][i], w[1][i], w[2][i], w[3][i], R()));
+        Assert(select_2_5_network(w[0][i], w[1][i], w[2][i], w[3][i], w[4][i], R()) ==
+               select_2_5<0,1,2,3,4>(w[0][i], w[1][i], w[2][i], w[3][i], w[4][i], R()));
+    }
+    P o[n];
+    Assert(select_1_4_n(w[0], w[1], w[2], w[3], n, o, R()) == o + n);
+    for (int i = 0; i < n; i = successor(i))
+        Assert(o[i] == select_1_4<0,1,2,3>(w[0][i], w[1][i], w[2][i], w[3][i], R()));
+    Assert(median_5_n(w[0], w[1], w[2], w[3], w[4], n, o, R()) == o + n);
+    for (int i = 0; i < n; i = successor(i))
+        Assert(o[i] == median_5(w[0][i], w[1][i], w[2][i], w[3][i], w[4][i], R()));
+
+    // A median filter over a sequence with many equal keys
+    P s[1000];
+    unsigned x = 1u;
+    for (int i = 0; i < 1000; i = successor(i)) {
+        x = x * 1103515245u + 12345u;
+        s[i] = P(int((x >> 16) % 4u), i);
+    }
+    Assert(median_5_filter_n(s, 1000, o, R()) == o + 996);
+    for (int i = 0; i < 996; i = successor(i))
+        Assert(o[i] == median_5(s[i], s[i + 1], s[i + 2], s[i + 3], s[i + 4], R()));
+    int t[] = {5, 1, 4, 2, 3, 9, 0};
+    int u[3];
+    median_5_filter_n(t, 7, u, less<int>());
+    Assert(u[0] == 3 && u[1] == 3 && u[2] == 3);
+
+    // A relation given by a function pointer
+    Assert(select_1_4_network(5, 1, 4, 2, less_int) == 2);
+    Assert(select_2_5_network(5, 1, 4, 2, 3, less_int) == 3);
+    u[0] = u[1] = u[2] = 0;
+    median_5_filter_n(t, 7, u, less_int);
+    Assert(u[0] == 3 && u[1] == 3 && u[2] == 3);
+}
+
+template<int k, int n>
+void algorithm_select_k_n()
+{
+    // Exhaustive over keys in $[0, 3)$, against the stable rank
+    typedef pair<int, int> P;
+    typedef less_first<int, int> R;
+    int c(1);
+    for (int i = 0; i < n; i = successor(i)) c = 3 * c;
+    for (int i = 0; i < c; i = successor(i)) {
+        P w[n];
+        int h = i;
+        for (int j = 0; j < n; j = successor(j)) { w[j] = P(h % 3, j); h = h / 3; }
+        pointer(P) s = select_k_n<k, n>(w, R());
+        int rank(0);
+        for (int j = 0; j < n; j = successor(j))
+            if (w[j].m0 < source(s).m0 || (w[j].m0 == source(s).m0 && j < source(s).m1))
+                rank = successor(rank);
+        Assert(rank == k);
+    }
+}
+
+template<int k, int n>
+struct algorithm_select_k_n_all
+{
+    static void run()
+    {
+        algorithm_select_k_n<k, n>();
+        algorithm_select_k_n_all<k + 1, n>::run();
+    }
+};
+
+template<int n>
+struct algorithm_select_k_n_all<n, n>
+{
+    static void run() { }
+};
+
+void algorithm_select_k_n_stability()
+{
+    print("    select_k_n\n");
+    algorithm_select_k_n_all<0, 1>::run();
+    algorithm_select_k_n_all<0, 2>::run();
+    algorithm_select_k_n_all<0, 3>::run();
+    algorithm_select_k_n_all<0, 4>::run();
+    algorithm_select_k_n_all<0, 5>::run();
+    algorithm_select_k_n_all<0, 6>::run();
+    algorithm_select_k_n_all<0, 7>::run();
+    algorithm_select_k_n_all<0, 9>::run();
+    algorithm_select_k_n<5, selection_network_max>();
+    int a[] = {5, 1, 4, 2, 3};
+    Assert(select_k_n<2, 5>(a, less<int>()) ==
+           &select_2_5<0,1,2,3,4>(a[0], a[1], a[2], a[3], a[4], less<int>()));
+    Assert(select_k_n<1, 4>(a, less<int>()) ==
+           &select_1_4<0,1,2,3>(a[0], a[1], a[2], a[3], less<int>()));
+    int b[] = {3, 3, 3, 3, 3, 3, 3, 3, 3};
+    Assert(select_k_n<4, 9>(b, less<int>()) == b + 4);
+    Assert(select_k_n<8, 9>(b, less<int>()) == b + 8);
+    Assert(select_k_n<0, 9>(b, less<int>()) == b);
+    Assert(select_k_n<2, 5>(a, less_int) == a + 4);
+    Assert(select_k_n<4, 9>(b, less_int) == b + 4);
+}
+
 void test_ch_4()
 {
     print("  Chapter 4\n");
@@ -1088,6 +1723,8 @@ void test_ch_4()
         Assert(median_5(1, cb, b, d, 15, less<int>()) == 12);
         Assert(median_5(ca, cb, cc, cd, ce, less<int>()) == 3);
         algorithm_median_5();
+        algorithm_select_network();
+        algorithm_select_k_n_stability();
     }
 
     {
@@ -1427,6 +2064,17 @@ bool operator<(const rational<N>& x, const rational<N>& y)
     return x.p * y.q < y.p * x.q;
 }
 
+template<typename N>
+    requires(IntegralDomain(N))
+rational<N> normalize(const rational<N>& x)
+{
+    // Postcondition: equal to $x$, in lowest terms with positive denominator
+    if (x.p == N(0)) return rational<N>(N(0), N(1));
+    N g = abs(gcd<N, N>(x.p, x.q));
+    if (x.q < N(0)) g = -g;
+    return rational<N>(x.p / g, x.q / g);
+}
+
 template<typename N>
     requires(IntegralDomain(N))
 void print(const rational<N>& x)
@@ -1495,352 +2143,355 @@ struct quotient_type<double>
 };
 
 
-// polynomial<T> is a type constructor; it models the following concept
-// There could be other models, such as sparse representations.
-
-// PolynomialRing(T) equals by definition
-//     ValueType : Polynomial -> CommutativeSemiring
-//     IndexType : Polynomial -> Integer
-//  /\ degree : T -> IndexType(T)
-//  /\ coefficient : T x IndexType(T) -> ValueType(T)
-//  /\ lc : T > ValueType(T)
-//            a \mapsto coefficient(a, degree(a))
-//  /\ tc : T > ValueType(T)
-//            a \mapsto coefficient(a, 0)
-//  /\ indeterminate : -> T
-//  /\ evaluate : T x ValueType(T) -> ValueType(T)
-//  /\  : ValueType(T) x T -> T
-//  /\ + : T x T -> T
-//  /\  : T x T -> T
-//  /\ shift_left : T x Integer -> T
-//        (a, n) \mapsto power(indeterminate(), n, )  a
-//  /\  ...
-
-
-template<typename T>
-    requires(Ring(T))
-struct polynomial
-{
-    typedef int IndexType;
-    array<T> coeff;
-    // Invariant: degree(f) = size(f.coeff) - 1 /\
-    //            coefficient(f, i) = f.coeff[degree(f) - i]
-    polynomial() : coeff(IndexType(1), IndexType(1), T(0)) { }     // f(x) = 0
-    polynomial(T x_0) : coeff(IndexType(1), IndexType(1), x_0) { } // f(x) = x_0
-};
-
-template<typename T>
-    requires(Ring(T))
-struct value_type< polynomial<T> >
-{
-    typedef T type;
-};
-
-template<typename T>
-    requires(Ring(T))
-struct index_type;
-
-#define IndexType(T) typename index_type< T >::type
-
-template<typename T>
-    requires(Ring(T))
-struct index_type< polynomial<T> >
-{
-    typedef typename polynomial<T>::IndexType type;
-};
-
-template<typename T>
-    requires(Ring(T))
-IndexType(polynomial<T>) operator==(const polynomial<T>& f, const polynomial<T>& g)
-{
-    return f.coeff == g.coeff;
-}
-
-template<typename T>
-    requires(Ring(T))
-IndexType(polynomial<T>) operator<(const polynomial<T>& f, const polynomial<T>& g)
-{
-    return degree(f) < degree(g) ||
-          degree(g) == degree(f) && f.coeff < g.coeff;
-}
-
-template<typename T>
-    requires(Ring(T))
-IndexType(polynomial<T>) degree(const polynomial<T>& f)
-{
-    // ***** Should degree(polynomial<T>(0)) = -infinity ?????
-    return predecessor(size(f.coeff));
-}
-
-template<typename T>
-    requires(Ring(T))
-void shift_add_in_place(polynomial<T>& f, const T& x_0)
-{
-    insert(back< array<T> >(f.coeff), x_0);
-    // Postcondition: f'(x) = x * f(x) + x_0
-}
-
-template<typename T>
-    requires(Ring(T))
-void shift_left_in_place(polynomial<T>& f, IndexType(polynomial<T>) n)
-{
-    // Precondition: n >= 0
-    while (count_down(n)) shift_add_in_place(f, T(0));
-    // Postcondition: f'(x) = x^n * f(x)
-}
-
-template<typename T>
-    requires(Ring(T))
-T coefficient(const polynomial<T>& f, IndexType(polynomial<T>) i)
-{
-    // Precondition: $0 \leq i \leq \func{degree}(f)$
-    return f.coeff[degree(f) - i]; // not a reference, to guarantee the invariant holds
-}
-
-template<typename T>
-    requires(Ring(T))
-T lc(const polynomial<T>& f) // leading coefficient
-{
-    return f.coeff[0];
-    // Poscondition: returns coefficient(f, degree(f))
-}
-
-template<typename T>
-    requires(Ring(T))
-T tc(const polynomial<T>& f) // trailing coefficient
-{
-    return f.coeff[size(f.coeff) - 1];
-    // Poscondition: returns coefficient(f, 0)
-}
-
-template<typename T>
-    requires(Ring(T))
-bool monic(const polynomial<T>& f)
-{
-    return lc(f) == T(1);
-}
-
-template<typename T>
-    requires(Ring(T))
-polynomial<T> indeterminate()
-{
-    polynomial<T> f(T(1)); // f(x) = 1
-    shift_add_in_place(f, T(0)); // f'(x) = f(x) * x + 0 = 1 * x = x
-    return f; // could be a static const member
-    // Postcondition: returns f(x) = x
-}
-
 template<typename T>
-    requires(Ring(T))
-polynomial<T> evaluate(const polynomial<T>& f, const T& x_0)
+    requires(Integer(T))
+void algorithm_gcd_n()
 {
-    typedef IndexType(polynomial<T>) I;
-    I n(degree(f));
-    // Horner's scheme
-    T r = coefficient(f, n);
-    while (!negative(n)) {
-        n = predecessor(n);
-        r = (r * x_0) + coefficient(f, n);
-    }
-    return r;
-    // Postcondition: r = f(x_0)
+    typedef pointer(T) I;
+    typedef DistanceType(I) N;
+    N n = N(3 * gcd_grain + 5);
+    array<T> x(n, n, T(0));
+    array<T> y(n, n, T(0));
+    array<T> z(n, n, T(0));
+    unsigned long long s = 1;
+    for (N i = 0; i < n; i = successor(i)) {
+        s = s * 6364136223846793005ull + 1442695040888963407ull;
+        x[i] = T(s >> 40) * T(12);
+        y[i] = T((s >> 20) & 0xfffff) << (i % 5);
+        if (i % 3 == 0)  x[i] = -x[i];
+        if (i % 11 == 0) y[i] = T(0);
+        if (i % 13 == 0) x[i] = T(0);
+    }
+    Assert(gcd_n(begin(x), n, begin(y), begin(z)) == begin(z) + n);
+    for (N i = 0; i < n; i = successor(i))
+        Assert(z[i] == (x[i] == T(0) && y[i] == T(0) ?
+                        T(0) : gcd<T, T>(x[i], y[i])));
+    array<T> w(n, n, T(-1));
+    Assert(gcd_n(begin(x), n, begin(y), begin(w), 4) == begin(w) + n);
+    Assert(w == z);
+    Assert(reduce_gcd_n(begin(x), N(0)) == T(0));
+    Assert(reduce_gcd_n(begin(y), N(1)) == T(0));
+    Assert(reduce_gcd_n(begin(x), n) == T(12));
+    Assert(reduce_gcd_n(begin(x), n, 4) == T(12));
+    Assert(reduce_gcd_n(begin(x) + 1, N(gcd_lanes + 3)) ==
+           reduce(begin(x) + 1, begin(x) + (gcd_lanes + 4),
+                  binary_gcd<T>, T(0)));
+    Assert(reduce_gcd_n(begin(y), n) == T(1));
+    Assert(reduce_gcd_n(begin(y), n, 4) == T(1));
 }
 
 template<typename T>
-    requires(Ring(T))
-polynomial<T> add(const polynomial<T>& f, const polynomial<T>& g,
-                  IndexType(polynomial<T>) d, IndexType(polynomial<T>) n_g)
-{
-    // Precondition: $0 < d = degree(f) - degree(g) \wedge n_g = degree(g)$
-    typedef IndexType(polynomial<T>) I;
-    polynomial<T> h(lc(f));
-    I i(1);
-    while (i != d) {
-        shift_add_in_place(h, f.coeff[i]);
-        i = successor(i);
-    }
-    I j(0);
-    while (j <= n_g) {
-        shift_add_in_place(h, f.coeff[i] + g.coeff[j]);
-        i = successor(i);
-        j = successor(j);
+    requires(EuclideanDomain(T))
+void algorithm_extended_gcd(const T& a, const T& b, const T& g)
+{
+    // Precondition: $g$ is the nonnegative gcd of $a$ and $b$
+    triple<T, T, T> t = extended_gcd(a, b);
+    Assert(t.m0 == g || t.m0 == -g);
+    // The products can exceed $T$ even though their sum is $t.m0$
+    typedef big_integer I;
+    Assert(I(t.m0) == I(a) * I(t.m1) + I(b) * I(t.m2));
+}
+
+void algorithm_extended_gcd()
+{
+    typedef big_integer I;
+    algorithm_extended_gcd(240, 46, 2);
+    algorithm_extended_gcd(-240, 46, 2);
+    algorithm_extended_gcd(0, -7, 7);
+    algorithm_extended_gcd(7ll, 0ll, 7ll);
+    algorithm_extended_gcd(I(240), I(-46), I(2));
+    algorithm_extended_gcd(I(0), I(-7), I(7));
+    algorithm_extended_gcd(I(-7), I(0), I(7));
+    Assert(extended_gcd(I(-240), I(46)).m0 == I(2));
+    unsigned long long s = 1;
+    for (int i = 0; i < 100; i = successor(i)) {
+        s = s * 6364136223846793005ull + 1442695040888963407ull;
+        long long a = (long long)(s >> 3);
+        s = s * 6364136223846793005ull + 1442695040888963407ull;
+        long long b = (long long)(s >> (3 + i % 50));
+        if (odd(i)) b = -b;
+        algorithm_extended_gcd(a, b, gcd<long long>(a, b));
+        algorithm_extended_gcd(I(a), I(b), I(gcd<long long>(a, b)));
+    }
+    // Consecutive Fibonacci numbers make every quotient 1, the worst case
+    // for Euclid and for the cofactors of Lehmer's algorithm
+    I f0 = fibonacci(I(2000));
+    I f1 = fibonacci(I(1999));
+    algorithm_extended_gcd(f0, f1, I(1));
+    algorithm_extended_gcd(f1, -f0, I(1));
+    for (int i = 1; i < 40; i = i + 3) {
+        I x(1);
+        I y(1);
+        I z(1);
+        for (int j = 0; j < i; j = successor(j)) {
+            s = s * 6364136223846793005ull + 1442695040888963407ull;
+            x = x * I(1ull << 32) * I(1ull << 32) + I(s);
+            s = s * 6364136223846793005ull + 1442695040888963407ull;
+            y = y * I(1ull << 32) * I(1ull << 32) + I(s);
+            if (j < i / 2) {
+                s = s * 6364136223846793005ull + 1442695040888963407ull;
+                z = z * I(1ull << 32) * I(1ull << 32) + I(s);
+            }
+        }
+        I g = stein_gcd_nonnegative(x, y);
+        Assert(gcd<I>(x, y) == g);
+        Assert(gcd<I>(-x * z, y * z) == g * z);
+        algorithm_extended_gcd(x * z, y * z, g * z);
+        algorithm_extended_gcd(x, y * z * z, stein_gcd_nonnegative(x, y * z * z));
+    }
+    // Modular inverses
+    Assert(multiplicative_inverse_modulo(3, 7) == 5);
+    Assert(multiplicative_inverse_modulo(-3, 7) == 2);
+    Assert(multiplicative_inverse_modulo(1, 2) == 1);
+    I p = binary_scale_up_nonnegative(I(1), 127) - I(1); // prime
+    Assert(multiplicative_inverse_modulo(I(3), p) * I(3) % p == I(1));
+    Assert(multiplicative_inverse_modulo(f0, p) * f0 % p == I(1));
+    {
+        LCG f[4] = {lehmer_1949(),
+                    LCG(0x80000000ll, 11035135245ll, 12345ll, 12345ll, "ANSIC"),
+                    LCG(576460752303423488ll, 302875106592253ll, 0ll,
+                        530242871347629333ll, "NAG"),
+                    LCG(999999999989ll, 427619669081ll, 0ll, 1ll, "MAPLE")};
+        for (int i = 0; i < 4; i = successor(i)) {
+            LCG g = inverse(f[i]);
+            long long x = f[i].x0;
+            for (int j = 0; j < 100; j = successor(j)) {
+                Assert(g(f[i](x)) == x);
+                x = f[i](x);
+            }
+        }
     }
-    return h;
-    // Postcondition: h(x) = f(x) + g(x)
 }
 
-template<typename T>
-    requires(Ring(T))
-polynomial<T> operator+(const polynomial<T>& f, const polynomial<T>& g)
-{
-    typedef IndexType(polynomial<T>) I;
-    I n_f = degree(f);
-    I n_g = degree(g);
-    if (n_f > n_g) return add(f, g, n_f - n_g, n_g);
-    else if (n_g > n_f) return add(g, f, n_g - n_f, n_f);
-    I i(0);
-    T x;
-    while (i <= n_f) {
-        x = f.coeff[i] + g.coeff[i];
-        if (x != T(0)) break;
-        i = successor(i);
-    }
-    polynomial<T> h(x);
-    while (i < n_f) {
-        i = successor(i);
-        shift_add_in_place(h, f.coeff[i] + g.coeff[i]);
-    };
-    return h;
-    // Postcondition: h(x) = f(x) + g(x)
-}
-
-template<typename T, typename F>
-    requires(Ring(T) && Transformation(F) &&
-        T == Domain(F))
-void transform_coefficients_in_place(polynomial<T>& f, F trans)
-{
-    typedef IndexType(polynomial<T>) I;
-    I i(0);
-    I n = degree(f);
-    while (i <= n) {
-        f.coeff[i] = trans(f.coeff[i]);
-        i = successor(i);
-    }
+template<typename N>
+    requires(Integer(N))
+void algorithm_lazy_rational()
+{
+    typedef lazy_rational<N> R;
+    typedef rational<long long> Q1;
+    algorithm_abs<R>(R(N(1), N(2)));
+    Assert(R(N(1), N(3)) < R(N(1), N(2)) && R(N(-1), N(2)) < R(N(0)));
+    Assert(R(N(2), N(-4)) == R(N(-1), N(2)) && R(N(2), N(-4)).q == N(4));
+    Assert(gcd<R, R>(R(N(3), N(4)), R(N(1), N(2))) == R(N(1), N(4)));
+    Assert(gcd<R, R>(R(N(3), N(4)), R(N(0), N(2))) == R(N(3), N(4)));
+    Assert(gcd<R, R>(R(N(0), N(4)), R(N(1), N(2))) == R(N(1), N(2)));
+    Assert(remainder(R(N(-7), N(2)), R(N(3), N(2))) == R(N(-1), N(2)));
+    Assert(R(N(3), N(4)) / R(N(-3), N(2)) == R(N(-1), N(2)));
+    Assert(multiplicative_inverse(R(N(-3), N(4))) == R(N(-4), N(3)));
+    Assert(N(6) * R(N(1), N(4)) == R(N(3), N(2)));
+    // The harmonic numbers overflow $N$ without reduction well before $H_{20}$
+    R h(N(0));
+    Q1 e(0ll);
+    for (int k = 1; k <= 20; k = successor(k)) {
+        h = h + R(N(1), N(k));
+        e = normalize(e + Q1(1ll, (long long)(k)));
+        Assert(h == R(N(e.p), N(e.q)));
+    }
+    R h1 = normalize(h);
+    Assert(h1.p == N(55835135) && h1.q == N(15519504));
+    Assert(h - h == R(N(0)) && h * R(N(2), N(3)) / R(N(2), N(3)) == h);
+    array<R> a(1000, 1000, R(N(0)));
+    for (int i = 0; i < 1000; i = successor(i))
+        a[i] = R(N(i % 37 - 18) * N(i % 7 + 1), N(i % 11 + 1) * N(i % 7 + 1));
+    array<R> b(a);
+    Assert(normalize_n(begin(b), 1000) == begin(b) + 1000);
+    for (int i = 0; i < 1000; i = successor(i))
+        Assert(b[i].p == normalize(a[i]).p && b[i].q == normalize(a[i]).q &&
+               b[i] == a[i]);
 }
 
 template<typename T>
     requires(Ring(T))
-polynomial<T> operator-(polynomial<T> f) // f is a copy
+polynomial<T> random_polynomial(int n, unsigned long long& s)
 {
-    transform_coefficients_in_place(f, negate<T>());
+    // Returns a polynomial of degree $n$ with coefficients below $2^{20}$
+    // in magnitude and a nonzero leading coefficient
+    polynomial<T> f;
+    f.coeff = array<T>(n + 1, n + 1, T(0));
+    for (int i = 0; i <= n; i = successor(i)) {
+        s = s * 6364136223846793005ull + 1442695040888963407ull;
+        f.coeff[i] = T((long long)(s >> 43) - (1ll << 20));
+    }
+    if (zero(f.coeff[0])) f.coeff[0] = T(1);
     return f;
-    // Postcondition: f'(x) = -f(x)
 }
 
 template<typename T>
     requires(Ring(T))
-polynomial<T> operator-(const polynomial<T>& f, const polynomial<T>& g)
-{
-    return f + (-g);
-    // Postcondition: returns h(x) = f(x) - g(x)
-}
-
-template<typename T>
-    requires(Ring(T))
-polynomial<T> product(const polynomial<T>& f, const polynomial<T>& g)
-{
-    // Precondition: degree(f) <= degree(g)
-    typedef IndexType(polynomial<T>) I;
-    I n_f = degree(f);
-    I n = n_f + degree(g);
-    polynomial<T> h(lc(f) * lc(g));
-    n = predecessor(n);
-    // Invariant: shift_left(r, n) is the
-    //            (deg(f)+deg(g)-n) highest-order coefficients of the result
-    while (!negative(n)) {
-        T sum(0);
-        I i_f(0);
-        while (i_f <= min(n_f, n)) {
-            sum = sum + coefficient(f, i_f) * coefficient(g, n - i_f);
-            i_f = successor(i_f);
+void algorithm_polynomial_product()
+{
+    int n[] = { 1, 2, 31, 32, 33, 64, 100, 257, 1000 };
+    unsigned long long s = 1;
+    for (int i = 0; i < int(sizeof(n) / sizeof(int)); i = successor(i)) {
+        for (int j = 0; j <= i; j = successor(j)) {
+            polynomial<T> f = random_polynomial<T>(n[i] - 1, s);
+            polynomial<T> g = random_polynomial<T>(n[j] - 1, s);
+            int m = n[i] + n[j] - 1;
+            array<T> e(m, m, T(0));
+            convolution_schoolbook(begin(f.coeff), n[i], begin(g.coeff), n[j], begin(e));
+            Assert((f * g).coeff == e && (g * f).coeff == e);
         }
-        shift_add_in_place(h, sum);
-        n = predecessor(n);
     }
-    return h;
-    // Postcondition: h(x) = f(x) * g(x)
+    polynomial<T> x = indeterminate<T>();
+    Assert(x * x == shift_left(polynomial<T>(T(1)), 2));
+    Assert((x + polynomial<T>(T(1))) * (x - polynomial<T>(T(1))) ==
+           shift_left(polynomial<T>(T(1)), 2) - polynomial<T>(T(1)));
 }
 
 template<typename T>
-    requires(Ring(T))
-polynomial<T> operator*(const polynomial<T>& f, const polynomial<T>& g)
-{
-    if (degree(f) <= degree(g)) return product(f, g);
-    else                        return product(g, f);
+    requires(Field(T))
+void algorithm_polynomial_quotient_remainder()
+{
+    typedef polynomial<T> P;
+    unsigned long long s = 2;
+    P f = random_polynomial<T>(300, s);
+    P g = random_polynomial<T>(100, s);
+    pair<P, P> qr = quotient_remainder(f, g);
+    Assert(qr.m0 * g + qr.m1 == f && degree(qr.m1) < degree(g));
+    qr = quotient_remainder(g, f);
+    Assert(qr.m0 == P(T(0)) && qr.m1 == g);
+    qr = quotient_remainder(f * g, g);
+    Assert(qr.m0 == f && qr.m1 == P(T(0)));
+    // $\gcd(f c, (f + 1) c)$ is $c$, up to a unit
+    P c = random_polynomial<T>(40, s);
+    P d = gcd<P>(f * c, (f + P(T(1))) * c);
+    Assert(multiplicative_inverse(lc(d)) * d == multiplicative_inverse(lc(c)) * c);
+    Assert(degree(gcd<P>(f, f + P(T(1)))) == 0);
+    int n[][2] = { { 700, 300 }, { 1500, 600 }, { 1000, 999 }, { 600, 0 } };
+    for (int i = 0; i < int(sizeof(n) / sizeof(n[0])); i = successor(i)) {
+        P a = random_polynomial<T>(n[i][0], s);
+        P b = random_polynomial<T>(n[i][1], s);
+        pair<P, P> x = quotient_remainder_newton(a, b);
+        pair<P, P> y = quotient_remainder_schoolbook(a, b);
+        Assert(x.m0 == y.m0 && x.m1 == y.m1);
+        Assert(quotient_remainder_newton(a * b, b).m1 == P(T(0)));
+    }
+    array<T> h(1000, 1000, T(0));
+    power_series_inverse(begin(g.coeff), 101, 1000, begin(h));
+    array<T> e(1100, 1100, T(0));
+    convolution(begin(g.coeff), 101, begin(h), 1000, begin(e));
+    Assert(e[0] == T(1));
+    for (int i = 1; i < 1000; i = successor(i)) Assert(zero(e[i]));
 }
 
 template<typename T>
     requires(Ring(T))
-polynomial<T> operator*(T x_0, const polynomial<T>& f)
-{
-    polynomial<T> h(f);
-    transform_coefficients_in_place(
-        h, multiplies_transformation< multiplies<T> >(x_0, multiplies<T>()));
-    return h;
-    // Postcondition: h(x) = x_0 * f(x)
+void algorithm_polynomial_evaluate()
+{
+    typedef polynomial<T> P;
+    unsigned long long s = 3;
+    P x = indeterminate<T>();
+    Assert(evaluate(P(T(5)), T(2)) == T(5));
+    Assert(evaluate(x * x + x + P(T(1)), T(3)) == T(13));
+    Assert(shift_left(x + P(T(1)), 3) == x * x * x * (x + P(T(1))));
+    P f = random_polynomial<T>(6, s); // $|f(x)| < 2^{63}$ for $|x| \leq 50$
+    array<T> a(100, 100, T(0));
+    array<T> b(100, 100, T(0));
+    for (int i = 0; i < 100; i = successor(i)) a[i] = T(i - 50);
+    for (int n = 0; n <= 100; n = n + 7) {
+        Assert(evaluate_n(f, begin(a), n, begin(b)) == begin(b) + n);
+        for (int i = 0; i < n; i = successor(i)) Assert(b[i] == evaluate(f, a[i]));
+    }
+    Assert(evaluate(f, T(1)) == evaluate(f * P(T(1)), T(1)));
+    Assert(evaluate(f * f, T(-2)) == evaluate(f, T(-2)) * evaluate(f, T(-2)));
 }
 
 template<typename T>
     requires(Ring(T))
-polynomial<T> shift_left(const polynomial<T>& f, IndexType(polynomial<T>) n)
+polynomial<T> random_sparse_polynomial(int n, int k, unsigned long long& s)
 {
-    polynomial<T> h(f);
-    shift_left_in_place(h, n);
-    return h;
-    // Postcondition: h(x) = x^n * f(x)
-}
-
-template<typename T>
-    requires(Ring(T))
-pair< polynomial<T>, polynomial<T> >
-quotient_remainder(const polynomial<T>& f, const polynomial<T>&g) {
-    // Precondition: unit(lc(g))
-    T u = multiplicative_inverse(lc(g));
-    polynomial<T> q(0);
-    polynomial<T> r = f;
-    while (degree(r) >= degree(g)) {
-        // Invariant: f = q * g + r
-        polynomial<T> q_i =  shift_left(polynomial<T>(lc(r) * u), degree(r) - degree(g));
-        q = q + q_i;
-        r = r - q_i * g;
-    }
-    return pair< polynomial<T>, polynomial<T> >(q, r);
-    // Postcondition: f = q * g + r /\ degree(r) < degree(g)
+    // Returns a polynomial of degree $n$ with at most $k + 1$ nonzero terms
+    polynomial<T> f = random_polynomial<T>(0, s);
+    shift_left_in_place(f, n);
+    for (int i = 0; i < k; i = successor(i)) {
+        s = s * 6364136223846793005ull + 1442695040888963407ull;
+        f.coeff[int((s >> 33) % (unsigned long long)(n + 1))] =
+            T((long long)(s >> 54) - (1ll << 9));
+    }
+    if (zero(f.coeff[0])) f.coeff[0] = T(1);
+    return f;
 }
 
 template<typename T>
-    requires(Ring(T))
-polynomial<T> remainder(const polynomial<T>& f, const polynomial<T>&g) {
-    // Precondition: unit(lc(g))
-    return quotient_remainder(f, g).m1;
+    requires(Field(T))
+void algorithm_sparse_polynomial()
+{
+    typedef polynomial<T> P;
+    typedef sparse_polynomial<T> S;
+    unsigned long long s = 4;
+    S x = sparse_indeterminate<T>();
+    Assert(S(T(0)) == S() && degree(S()) == 0 && lc(S()) == T(0));
+    Assert(x * x == shift_left(S(T(1)), 2) && x * x == S(T(1), 2));
+    Assert((x + S(T(1))) * (x - S(T(1))) == S(T(1), 2) - S(T(1)));
+    Assert(S(P(T(0))) == S() && S(indeterminate<T>()) == x);
+    Assert(x - x == S() && T(0) * x == S());
+    int n[][4] = { { 0, 0, 5, 0 }, { 100, 10, 50, 40 },
+                   { 3000, 40, 2000, 30 }, { 10000, 200, 9000, 150 } };
+    for (int i = 0; i < int(sizeof(n) / sizeof(n[0])); i = successor(i)) {
+        P f = random_sparse_polynomial<T>(n[i][0], n[i][1], s);
+        P g = random_sparse_polynomial<T>(n[i][2], n[i][3], s);
+        S f_s(f);
+        S g_s(g);
+        Assert(degree(f_s) == degree(f) && lc(f_s) == lc(f) && tc(f_s) == tc(f));
+        for (int j = 0; j <= degree(f); j = successor(j))
+            Assert(coefficient(f_s, j) == coefficient(f, j));
+        Assert(f_s + g_s == S(f + g) && f_s - g_s == S(f - g));
+        Assert(f_s * g_s == S(f * g) && g_s * f_s == S(f * g));
+        Assert(shift_left(f_s, 7) == S(shift_left(f, 7)));
+        Assert(evaluate(f_s, T(3)) == evaluate(f, T(3)));
+        pair<S, S> qr = quotient_remainder(f_s * g_s + x, g_s);
+        Assert(qr.m0 * g_s + qr.m1 == f_s * g_s + x);
+        Assert(empty(qr.m1.terms) || degree(qr.m1) < degree(g_s));
+    }
+    S d = gcd<S>((x - S(T(1))) * (x + S(T(2))), (x - S(T(1))) * (x - S(T(2))));
+    Assert(multiplicative_inverse(lc(d)) * d == x - S(T(1)));
 }
 
 template<typename T>
-    requires(Ring(T))
-void print_coefficient(T c, IndexType(polynomial<T>) i)
+    requires(Integer(T))
+void algorithm_invariant_divisor(T d)
 {
-    if (!one(c) || zero(i)) {
-        print(c);
-        if (positive(i)) print("*");
-    }
-    if (positive(i)) {
-        print("x");
-        if (i > IndexType(polynomial<T>)(1)) {
-            print("^"); print(i);
-        }
+    typedef QuotientType(T) N;
+    const T max = T(~(DistanceType(T)(1) << (sizeof(T) * 8 - 1)));
+    quotient_remainder_invariant<T> qr(d);
+    remainder_invariant<T> r(d);
+    // $d + 1$ would overflow for $d = max$, so $d$ stands in for it
+    T a[] = { T(0), T(1), d - T(1), d, d < max ? d + T(1) : d,
+              max / d * d - T(1), max / d * d, max - T(1), max };
+    for (int i = 0; i < int(sizeof(a) / sizeof(T)); i = successor(i)) {
+        if (a[i] < T(0)) continue;
+        Assert(qr(a[i], d).m0 == a[i] / d && qr(a[i], d).m1 == a[i] % d);
+        Assert(r(a[i], d) == a[i] % d);
+    }
+    T x(1);
+    for (int i = 0; i < 100; i = successor(i)) {
+        x = T(DistanceType(T)(x) * DistanceType(T)(2862933555777941757ull) +
+              DistanceType(T)(3037000493ull)) & max;
+        Assert(r(x, d) == x % d && qr(x, d).m0 == x / d);
+        pair<N, T> p = quotient_remainder(T(-(x % T(1000))), d, qr);
+        Assert(p.m0 * d + p.m1 == T(-(x % T(1000))) && T(0) <= p.m1 && p.m1 < d);
     }
 }
 
 template<typename T>
-    requires(Ring(T))
-void print(const polynomial<T>& f)
-{
-    typedef IndexType(polynomial<T>) I;
-    print("polynomial(");
-        I i = degree(f);
-        T c = coefficient(f, i);
-        print_coefficient(c, i);
-        i = predecessor(i);
-        while (!negative(i)) {
-            c = coefficient(f, i);
-            if (!zero(c)) {
-                if (negative(c)) { print(" - "); c = -c; }
-                else               print(" + ");
-                print_coefficient(c, i);
-            }
-            i = predecessor(i);
-        }
-    print(")");
+    requires(Integer(T))
+void algorithm_invariant_divisor()
+{
+    const T max = T(~(DistanceType(T)(1) << (sizeof(T) * 8 - 1)));
+    for (T d(1); d < T(1000); d = successor(d))
+        algorithm_invariant_divisor(d);
+    for (int i = 1; i < int(sizeof(T) * 8) - 1; i = successor(i)) {
+        T p = T(1) << i;
+        algorithm_invariant_divisor(p - T(1));
+        algorithm_invariant_divisor(p);
+        algorithm_invariant_divisor(p + T(1));
+        algorithm_invariant_divisor(max / p);
+    }
+    algorithm_invariant_divisor(max);
+    algorithm_invariant_divisor(max - T(1));
+    additive_congruential_transformation<T> f(T(1000), T(7));
+    for (T x(0); x < T(1000); x = successor(x))
+        Assert(f(x) == (x + T(7)) % T(1000));
 }
 
 void test_ch_5()
@@ -1977,6 +2628,44 @@ void test_ch_5()
     Assert(gcd<Q, Q>(Q(3, 4), Q(0, 2)) == Q(3, 4));
     Assert(gcd<Q, Q>(Q(0, 4), Q(1, 2)) == Q(1, 2));
 
+    // binary gcd for built-in integers
+    Assert(gcd<int>(-1000, 990) == 10);
+    Assert(gcd<int, int>(1000, -990) == 10);
+    Assert(gcd<long, long>(-(1l << 40), 0l) == (1l << 40));
+    Assert(gcd<long long>(3ll << 50, 5ll << 47) == (1ll << 47));
+    Assert(stein_gcd_nonnegative(0, 990) == 990);
+    Assert(stein_gcd_nonnegative(1000l, 990l) == 10l);
+    Assert(binary_gcd_nonnegative(0x80000000u, 0x80000000u) == 0x80000000u);
+    for (int a = 0; a < 64; a = successor(a))
+        for (int b = a == 0 ? 1 : 0; b < 64; b = successor(b)) {
+            int g = stein_gcd_nonnegative<int>(a, b);
+            Assert(gcd<int>(a, b) == g);
+            Assert(gcd<int>(-a, b) == g);
+            Assert(gcd<long long, long long>(a, -b) == g);
+            Assert(fast_subtractive_gcd(a, b) == g);
+        }
+    Assert(normalize(Q(-250, -1000)) == Q(1, 4) &&
+           normalize(Q(-250, -1000)).p == 1 &&
+           normalize(Q(-250, -1000)).q == 4);
+    Assert(normalize(Q(250, -1000)).p == -1);
+    Assert(normalize(Q(0, -1000)).q == 1);
+    algorithm_gcd_n<int>();
+    algorithm_gcd_n<long long>();
+    algorithm_extended_gcd();
+    algorithm_lazy_rational<int>();
+    algorithm_lazy_rational<long long>();
+    algorithm_invariant_divisor<int>();
+    algorithm_invariant_divisor<long long>();
+    algorithm_polynomial_product<long long>();
+    algorithm_polynomial_product< modular_integer<998244353u> >();
+    algorithm_polynomial_product< modular_integer<1000000007u> >();
+    algorithm_polynomial_product< modular_integer<1000u> >();
+    algorithm_polynomial_quotient_remainder< modular_integer<998244353u> >();
+    algorithm_polynomial_quotient_remainder< modular_integer<1000000007u> >();
+    algorithm_polynomial_evaluate<long long>();
+    algorithm_polynomial_evaluate< modular_integer<998244353u> >();
+    algorithm_sparse_polynomial< modular_integer<998244353u> >();
+
     algorithms_signed_q_and_r<int>();
     algorithms_signed_q_and_r<long>();
     algorithms_signed_q_and_r<Q>();
@@ -1986,6 +2675,94 @@ void test_ch_5()
 // Chapter 6. Iterators
 
 
+template<typename T>
+    requires(Regular(T) && TotallyOrdered(T))
+void algorithm_quantifiers_contiguous()
+{
+    // Compares the block-at-a-time quantifiers on $T*$ with the generic ones
+    typedef pointer(T) I;
+    typedef DistanceType(I) N;
+    typedef storage_tag C;
+    typedef predicate_tag D;
+    const int n = 4 * quantifier_lanes + 3;
+    T a[n];
+    for (int m = 0; m <= n; m = successor(m)) {
+        I f = a;
+        I l = a + m;
+        for (int j = -1; j < m; j = successor(j)) {
+            // $a[j] = 1$, the rest alternate between 0 and 2
+            for (int i = 0; i < m; i = successor(i)) a[i] = T(i == j ? 1 : 2 * (i % 2));
+            // lower_bound_predicate and upper_bound_predicate keep a reference to $one$
+            T one(1);
+            equal_to_x<T> p(one);
+            lower_bound_predicate< less<T> > lb(one, less<T>());
+            upper_bound_predicate< less<T> > ub(one, less<T>());
+            Assert(find(f, l, T(1)) == find(f, l, T(1), C()));
+            Assert(find(f, l, T(1)) == (j < 0 ? l : f + j));
+            Assert(find_not(f, l, T(2)) == find_not(f, l, T(2), C()));
+            Assert(find_if(f, l, p) == find_if(f, l, p, C(), D()));
+            Assert(find_if_not(f, l, lb) == find_if_not(f, l, lb, C(), D()));
+            Assert(find_if(f, l, ub) == find_if(f, l, ub, C(), D()));
+            Assert(count(f, l, T(2)) == count(f, l, T(2), N(0), C()));
+            Assert(count_not(f, l, T(2), N(7)) == count_not(f, l, T(2), N(7), C()));
+            Assert(count_if(f, l, p) == count_if(f, l, p, N(0), C(), D()));
+            Assert(count_if(f, l, p) == N(j < 0 ? 0 : 1));
+            Assert(count_if_not(f, l, ub, 3) == count_if_not(f, l, ub, 3, C(), D()));
+            Assert(all(f, l, lb) == (find_if_not(f, l, lb, C(), D()) == l));
+            Assert(none(f, l, p) == (j < 0));
+            Assert(some(f, l, p) == (j >= 0));
+        }
+    }
+}
+
+
+template<typename T>
+    requires(Regular(T) && TotallyOrdered(T))
+void algorithm_btree_index()
+{
+    // Compares the searches of a btree_index with lower_bound_n and
+    // upper_bound_n, over ranges with runs of equal elements, sizes around
+    // whole nodes and layers, and an increasing and a decreasing order
+    typedef pointer(T) I;
+    typedef DistanceType(I) N;
+    N b = N(btree_node_size<T>());
+    N a[] = {N(0), N(1), N(2), b - N(1), b, b + N(1), b * (b + N(1)),
+             b * (b + N(1)) + N(1), N(1000), N(4097)};
+    for (int h = 0; h < int(sizeof(a) / sizeof(N)); h = successor(h)) {
+        N n = a[h];
+        array<T> x(n, n, T(0));
+        array<T> y(n, n, T(0));
+        for (N i(0); i < n; i = successor(i)) {
+            x[i] = T(i / N(3));
+            y[i] = T((n - i) / N(3));
+        }
+        btree_index<I> e(begin(x), n);
+        btree_index<I> e_y(begin(y), n);
+        Assert(size(e) == n);
+        less<T> r;
+        converse< less<T> > r_y(r);
+        N m = n / N(3) + N(3);
+        array<T> q(m, m, T(0));
+        array<I> o(m, m, I(0));
+        for (N i(0); i < m; i = successor(i)) q[i] = T(i - N(1));
+        for (N i(0); i < m; i = successor(i)) {
+            T v = q[i];
+            Assert(lower_bound(e, v, r) == lower_bound_n(begin(x), n, v, r));
+            Assert(upper_bound(e, v, r) == upper_bound_n(begin(x), n, v, r));
+            Assert(lower_bound(e_y, v, r_y) ==
+                   lower_bound_n(begin(y), n, v, r_y));
+            Assert(upper_bound(e_y, v, r_y) ==
+                   upper_bound_n(begin(y), n, v, r_y));
+        }
+        Assert(lower_bounds_n(e, begin(q), m, begin(o), r) == end(o));
+        for (N i(0); i < m; i = successor(i))
+            Assert(o[i] == lower_bound_n(begin(x), n, q[i], r));
+        Assert(upper_bounds_n(e_y, begin(q), m, begin(o), r_y) == end(o));
+        for (N i(0); i < m; i = successor(i))
+            Assert(o[i] == upper_bound_n(begin(y), n, q[i], r_y));
+    }
+}
+
 // "Thunk"-style iterator
 
 template<typename T>
@@ -2059,6 +2836,13 @@ void test_ch_6()
 {
     print("  Chapter 6\n");
 
+    algorithm_quantifiers_contiguous<int>();
+    algorithm_quantifiers_contiguous<char>();
+    algorithm_quantifiers_contiguous<double>();
+    algorithm_btree_index<int>();
+    algorithm_btree_index<double>();
+    algorithm_btree_index<long long>();
+
     {
         int i;
         i = int(0); increment(i); Assert(i == int(1));
@@ -2845,22 +3629,6 @@ bool equal_iota_reverse(I f, I l)
     return true;
 }
 
-template<typename T>
-    requires(Regular(T))
-struct equal_to_x
-{
-    T x;
-    equal_to_x(const T& x) : x(x) { }
-    bool operator()(const T& y) { return x == y; }
-};
-
-template<typename T>
-    requires(Regular(T))
-struct input_type< equal_to_x<T>, 0 >
-{
-    typedef T type;
-};
-
 template<typename I0, typename I1>
     requires(Mutable(I0) && ForwardIterator(I0) &&
         Mutable(I1) && ForwardIterator(I1) &&
@@ -3680,6 +4448,54 @@ void algorithms_reduce_balanced()
     Assert(reduce_balanced(begin(l), successor(begin(l)), plus<Z>(), Z(0)) == Z(0));
 }
 
+struct shape_operation
+{
+    // $(3x + y + 1) \bmod 1000003$ is not associative, so its reductions
+    // tell trees of different shape apart
+    long long operator()(long long x, long long y)
+    {
+        return (3 * x + y + 1) % 1000003;
+    }
+};
+
+template<>
+struct input_type<shape_operation, 0>
+{
+    typedef long long type;
+};
+
+template<typename T, typename Op>
+    requires(BinaryOperation(Op) && T == Domain(Op))
+void algorithm_reduce_balanced_n(Op op, const T& z)
+{
+    // The parallel reduction is the sequential one, $z$ elements included
+    typedef pointer(T) I;
+    typedef DistanceType(I) N;
+    const N g = N(reduce_balanced_grain);
+    N a[] = {N(0), N(1), 2 * g - N(1), 2 * g, 3 * g + N(5), 7 * g + N(12345)};
+    unsigned long long s = 1;
+    for (int h = 0; h < int(sizeof(a) / sizeof(N)); h = successor(h)) {
+        N n = a[h];
+        array<T> x(n, n, z);
+        for (N i(0); i < n; i = successor(i)) {
+            s = s * 6364136223846793005ull + 1442695040888963407ull;
+            T v = T((s >> 33) % 1000003);
+            if (i % 17 != 0) x[i] = z == T(0) ? (v - T(500001)) / T(7) : v;
+        }
+        for (int k = 0; k < 2; k = successor(k)) {
+            if (k == 1)
+                for (N i = g; i < 2 * g + N(100) && i < n; i = successor(i))
+                    x[i] = z;
+            T r = reduce_balanced(begin(x), end(x), op, z);
+            Assert(reduce_balanced_n(begin(x), n, op, z, 1) == r);
+            Assert(reduce_balanced_n(begin(x), n, op, z, 2) == r);
+            Assert(reduce_balanced_n(begin(x), n, op, z, 3) == r);
+            Assert(reduce_balanced_n(begin(x), n, op, z, 4) == r);
+            Assert(reduce_balanced_n(begin(x), n, op, z, 7) == r);
+        }
+    }
+}
+
 bool even_int(int x) { return even<int>(x); }
 bool odd_int(int x) { return odd<int>(x); }
 typedef bool (*int_pred_type)(int);
@@ -3777,6 +4593,9 @@ void algorithms_partition()
     { // exercise
         partition_algorithm_tester t("single_cycle");
         t.validate(partition_single_cycle(t.f, t.l, t.p));
+        int a[] = {1, 2, 1, 1, 2};
+        Assert(partition_single_cycle(a, a + 5, odd<int>) == a + 2);
+        Assert(partitioned(a, a + 5, odd<int>));
     }
     { // exercise
         partition_algorithm_tester t("sentinel");
@@ -4032,6 +4851,8 @@ void test_ch_11()
 
     print("    reduce_balanced\n");
     algorithms_reduce_balanced();
+    algorithm_reduce_balanced_n(shape_operation(), -1ll);
+    algorithm_reduce_balanced_n(plus<double>(), 0.0);
 
     print("    partition\n");
     algorithms_partition();
@@ -111,16 +111,75 @@ struct distance_type<int>
     typedef unsigned int type;
 };
 
+template<>
+struct distance_type<long>
+{
+    typedef unsigned long type;
+};
+
 template<>
 struct distance_type<long long>
 {
     typedef unsigned long long type;
 };
 
+template<>
+struct distance_type<__int128>
+{
+    typedef unsigned __int128 type;
+};
+
 
 #define DistanceType(T) typename distance_type< T >::type
 
 
+// WideType : Integer -> Integer
+
+// An integral type holding any product of two values of the given one
+
+template<typename T>
+    requires(Integer(T))
+struct wide_type;
+
+template<>
+struct wide_type<int>
+{
+    typedef long long type;
+};
+
+template<>
+struct wide_type<long>
+{
+    typedef __int128 type;
+};
+
+template<>
+struct wide_type<long long>
+{
+    typedef __int128 type;
+};
+
+#define WideType(T) typename wide_type< T >::type
+
+
+// The TransformationTag concept has the following models:
+
+struct transformation_tag            {};
+struct composable_transformation_tag {};
+
+
+// TransformationConcept : Transformation -> TransformationTag
+
+template<typename F>
+    requires(Transformation(F))
+struct transformation_concept
+{
+    typedef transformation_tag concept;
+};
+
+#define TransformationConcept(F) typename transformation_concept< F >::concept
+
+
 // Chapter 3 - Associative operations
 
 template<typename T> 
@@ -211,6 +270,12 @@ struct quotient_type<long>
     typedef long type;
 };
 
+template<>
+struct quotient_type<long long>
+{
+    typedef long long type;
+};
+
 
 // Chapter 6 - Iterators
 
@@ -285,6 +350,42 @@ struct iterator_concept
 #define IteratorConcept(T) typename iterator_concept< T >::concept
 
 
+// The StorageTag concept has the following models:
+
+struct storage_tag            {};
+struct contiguous_storage_tag {}; // pointer to an arithmetic type
+
+
+// StorageConcept : Iterator -> StorageTag
+
+template<typename T>
+    requires(Iterator(T))
+struct storage_concept
+{
+    typedef storage_tag concept;
+};
+
+#define StorageConcept(T) typename storage_concept< T >::concept
+
+
+// The PredicateTag concept has the following models:
+
+struct predicate_tag            {};
+struct comparison_predicate_tag {}; // $x \mapsto x \odot a$, no side effects
+
+
+// PredicateConcept : UnaryPredicate -> PredicateTag
+
+template<typename P>
+    requires(UnaryPredicate(P))
+struct predicate_concept
+{
+    typedef predicate_tag concept;
+};
+
+#define PredicateConcept(P) typename predicate_concept< P >::concept
+
+
 // Chapter 12 - Composite objects
 
 